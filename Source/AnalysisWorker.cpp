@@ -0,0 +1,318 @@
+/*
+  ==============================================================================
+    Hisstory – AnalysisWorker.cpp
+  ==============================================================================
+*/
+
+#include "AnalysisWorker.h"
+
+namespace
+{
+    /** Resamples a per-bin array of another FFT size onto the editor's
+        displayFftSize grid as dest = src * scale + offset.  Longer FFTs keep
+        the largest bin under each display bin so narrow peaks stay visible;
+        shorter ones are interpolated linearly. */
+    void resampleToDisplay (const float* src, int srcFftSize, float* dest,
+                            float scale, float offset)
+    {
+        constexpr int displaySize = HisstoryAudioProcessor::displayFftSize;
+        const int srcNumBins = srcFftSize / 2 + 1;
+
+        for (int d = 0; d < HisstoryAudioProcessor::displayNumBins; ++d)
+        {
+            float value;
+
+            if (srcFftSize >= displaySize)
+            {
+                const int step  = srcFftSize / displaySize;
+                const int first = std::max (0, d * step - step / 2);
+                const int last  = std::min (srcNumBins, first + step);
+
+                value = src[first];
+                for (int bin = first + 1; bin < last; ++bin)
+                    value = std::max (value, src[bin]);
+            }
+            else
+            {
+                const float pos = static_cast<float> (d * srcFftSize) / static_cast<float> (displaySize);
+                const int   i0  = static_cast<int> (pos);
+                const int   i1  = std::min (i0 + 1, srcNumBins - 1);
+                value = src[i0] + (pos - static_cast<float> (i0)) * (src[i1] - src[i0]);
+            }
+
+            dest[d] = value * scale + offset;
+        }
+    }
+}
+
+//==============================================================================
+HisstoryAudioProcessor::AnalysisWorker::AnalysisWorker (HisstoryAudioProcessor& processor)
+    : juce::Thread ("Hisstory analysis"), owner (processor)
+{
+}
+
+HisstoryAudioProcessor::AnalysisWorker::~AnalysisWorker()
+{
+    stop();
+}
+
+void HisstoryAudioProcessor::AnalysisWorker::prepare (int newFftSize)
+{
+    stop();
+
+    fftSize = newFftSize;
+    numBins = newFftSize / 2 + 1;
+
+    const auto binCount = static_cast<size_t> (numBins);
+    slotData.assign (static_cast<size_t> (numSlots) * 4 * binCount, 0.0f);
+    fifo.reset();
+    pushedFrames.store (0);
+    analysedFrames.store (0);
+    droppedFrames.store (0);
+
+    inputSpectrumDB.assign (binCount, 0.0f);
+    outputSpectrumDB.assign (binCount, 0.0f);
+    prevResidualMag.assign (binCount, 0.0f);
+    isTonal.assign (binCount, 0);
+
+    // Each band control point owns the bins up to the geometric mean with
+    // its neighbours; the outer bands run to DC and Nyquist.
+    const float binHz = owner.currentSampleRate.load() / static_cast<float> (fftSize);
+    bandEdges.front() = 0;
+    bandEdges.back()  = numBins;
+
+    for (int b = 1; b < numBands; ++b)
+    {
+        const float edgeHz = std::sqrt (bandFrequencies[static_cast<size_t> (b - 1)]
+                                      * bandFrequencies[static_cast<size_t> (b)]);
+        bandEdges[static_cast<size_t> (b)] = juce::jlimit (0, numBins, static_cast<int> (edgeHz / binHz + 0.5f));
+    }
+
+    smoothedNoisePurity = 0.5f;
+    smoothedHLR         = 1.0f;
+    smoothedResFlux     = 0.0f;
+    bandReductionDB.fill (0.0f);
+    tonalBinCount       = 0;
+
+    startThread (juce::Thread::Priority::low);
+}
+
+void HisstoryAudioProcessor::AnalysisWorker::stop()
+{
+    signalThreadShouldExit();
+    wakeUp.notify();
+    stopThread (1000);
+}
+
+//==============================================================================
+//  Producer
+//==============================================================================
+bool HisstoryAudioProcessor::AnalysisWorker::push (const float* mags, const float* gains,
+                                                    const float* stationarity,
+                                                    const float* noiseProfile,
+                                                    uint32_t flags) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+    {
+        droppedFrames.fetch_add (1, std::memory_order_relaxed);
+        return false;
+    }
+
+    float* slot = slotData.data() + static_cast<size_t> (start1) * 4 * static_cast<size_t> (numBins);
+
+    if ((flags & hasSpectrum) != 0)
+    {
+        std::copy_n (mags,         numBins, slot);
+        std::copy_n (gains,        numBins, slot + numBins);
+        std::copy_n (stationarity, numBins, slot + 2 * numBins);
+    }
+
+    std::copy_n (noiseProfile, numBins, slot + 3 * numBins);
+    slotFlags[static_cast<size_t> (start1)] = flags;
+
+    fifo.finishedWrite (1);
+    pushedFrames.fetch_add (1, std::memory_order_release);
+
+    wakeUp.notify();
+    return true;
+}
+
+bool HisstoryAudioProcessor::AnalysisWorker::waitUntilIdle (int timeoutMs) const
+{
+    const auto deadline = juce::Time::getMillisecondCounterHiRes() + timeoutMs;
+
+    while (analysedFrames.load (std::memory_order_acquire) != pushedFrames.load (std::memory_order_acquire))
+    {
+        if (juce::Time::getMillisecondCounterHiRes() > deadline)
+            return false;
+
+        juce::Thread::sleep (1);
+    }
+
+    return true;
+}
+
+//==============================================================================
+//  Consumer
+//==============================================================================
+void HisstoryAudioProcessor::AnalysisWorker::run()
+{
+    while (! threadShouldExit())
+    {
+        if (fifo.getNumReady() == 0)
+        {
+            // Take the token before re-checking, so a push either lands
+            // after it and cuts the wait short, or its frame is seen here.
+            const auto token = wakeUp.prepareWait();
+
+            if (fifo.getNumReady() == 0 && ! threadShouldExit())
+                wakeUp.wait (token, 100);
+
+            continue;
+        }
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        analyse (slotData.data() + static_cast<size_t> (start1) * 4 * static_cast<size_t> (numBins),
+                 slotFlags[static_cast<size_t> (start1)]);
+
+        fifo.finishedRead (1);
+        analysedFrames.fetch_add (1, std::memory_order_release);
+    }
+}
+
+//==============================================================================
+//  Metrics and snapshot
+//==============================================================================
+void HisstoryAudioProcessor::AnalysisWorker::analyse (const float* slot, uint32_t flags)
+{
+    const float* mags         = slot;
+    const float* gains        = slot + numBins;
+    const float* stationarity = slot + 2 * numBins;
+    const float* noiseProfile = slot + 3 * numBins;
+
+    if ((flags & resetMetrics) != 0)
+    {
+        smoothedNoisePurity = 0.5f;
+        std::fill (prevResidualMag.begin(), prevResidualMag.end(), 0.0f);
+    }
+
+    if ((flags & hasSpectrum) != 0)
+    {
+        // ── Tonal bins: ≥ 7 dB above the neighbour average, plus neighbours ──
+        std::fill (isTonal.begin(), isTonal.end(), 0);
+        for (int bin = 3; bin < numBins - 3; ++bin)
+        {
+            const float neighbourAvg = (mags[bin - 2] * mags[bin - 2] + mags[bin - 1] * mags[bin - 1]
+                                      + mags[bin + 1] * mags[bin + 1] + mags[bin + 2] * mags[bin + 2]) * 0.25f;
+
+            if (mags[bin] * mags[bin] > neighbourAvg * 5.0f)
+                isTonal[static_cast<size_t> (bin - 1)] = isTonal[static_cast<size_t> (bin)]
+                                                       = isTonal[static_cast<size_t> (bin + 1)] = 1;
+        }
+
+        float noiseRemovedPower = 0.0f, musicRemovedPower = 0.0f;
+        float inputTonalPower   = 0.0f, outputTonalPower  = 0.0f;
+        float residualFluxSum   = 0.0f, residualTotalMag  = 0.0f;
+        std::array<float, numBands> bandInPower {}, bandOutPower {};
+        int   tonalBins = 0;
+        int   band      = 0;
+
+        const bool isBypassed = (flags & bypassed) != 0;
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            const float g      = gains[bin];
+            const float magSq  = mags[bin] * mags[bin];
+            const float outSq  = magSq * g * g;
+
+            inputSpectrumDB[static_cast<size_t> (bin)]  = juce::Decibels::gainToDecibels (mags[bin], -150.0f);
+            outputSpectrumDB[static_cast<size_t> (bin)] = isBypassed
+                                                        ? inputSpectrumDB[static_cast<size_t> (bin)]
+                                                        : juce::Decibels::gainToDecibels (mags[bin] * g, -150.0f);
+
+            // Noise Purity: classify removed energy as noise vs music
+            if (g < 0.999f)
+            {
+                const float removedPower = magSq - outSq;
+                noiseRemovedPower += removedPower * stationarity[bin];
+                musicRemovedPower += removedPower * (1.0f - stationarity[bin]);
+            }
+
+            // Harmonic Loss
+            if (isTonal[static_cast<size_t> (bin)] != 0)
+            {
+                inputTonalPower  += magSq;
+                outputTonalPower += outSq;
+                ++tonalBins;
+            }
+
+            // Residual Spectral Flux
+            const float resMag = mags[bin] * (1.0f - g);
+            residualFluxSum  += std::abs (resMag - prevResidualMag[static_cast<size_t> (bin)]);
+            residualTotalMag += resMag;
+            prevResidualMag[static_cast<size_t> (bin)] = resMag;
+
+            // Per-band reduction
+            while (bin >= bandEdges[static_cast<size_t> (band + 1)])
+                ++band;
+
+            bandInPower[static_cast<size_t> (band)]  += magSq;
+            bandOutPower[static_cast<size_t> (band)] += outSq;
+        }
+
+        constexpr float smooth = 0.95f;
+
+        const float totalRemoved = noiseRemovedPower + musicRemovedPower;
+        if (totalRemoved > 1e-20f)
+            smoothedNoisePurity = smooth * smoothedNoisePurity + (1.0f - smooth) * (noiseRemovedPower / totalRemoved);
+
+        // 0.0 = no tonal energy lost; 0.05 = 5 % lost; higher = more loss.
+        const float rawHarmLoss = (inputTonalPower > 1e-20f) ? (1.0f - outputTonalPower / inputTonalPower) : 0.0f;
+        smoothedHLR = smooth * smoothedHLR + (1.0f - smooth) * rawHarmLoss;
+
+        const float rawFlux = (residualTotalMag > 1e-20f) ? (residualFluxSum / residualTotalMag) : 0.0f;
+        smoothedResFlux = smooth * smoothedResFlux + (1.0f - smooth) * rawFlux;
+
+        for (size_t b = 0; b < bandReductionDB.size(); ++b)
+            bandReductionDB[b] = 10.0f * std::log10 ((bandOutPower[b] + 1e-20f) / (bandInPower[b] + 1e-20f));
+
+        tonalBinCount = tonalBins;
+    }
+
+    // ── Snapshot (every field: the buffer is two frames old) ─────────────────
+    auto& snapshot = owner.displaySnapshots.getWriteBuffer();
+
+    if (fftSize == displayFftSize)
+    {
+        std::copy (inputSpectrumDB.begin(),  inputSpectrumDB.end(),  snapshot.inputSpectrumDB);
+        std::copy (outputSpectrumDB.begin(), outputSpectrumDB.end(), snapshot.outputSpectrumDB);
+        std::copy_n (noiseProfile, numBins, snapshot.noiseProfile);
+    }
+    else
+    {
+        // A tone's bin magnitude grows with N; keep levels where the editor
+        // expects them for displayFftSize.
+        const float sizeRatio = static_cast<float> (fftSize) / static_cast<float> (displayFftSize);
+        const float offsetDB  = -20.0f * std::log10 (sizeRatio);
+
+        resampleToDisplay (inputSpectrumDB.data(),  fftSize, snapshot.inputSpectrumDB,  1.0f, offsetDB);
+        resampleToDisplay (outputSpectrumDB.data(), fftSize, snapshot.outputSpectrumDB, 1.0f, offsetDB);
+        resampleToDisplay (noiseProfile,            fftSize, snapshot.noiseProfile,     1.0f / sizeRatio, 0.0f);
+    }
+
+    snapshot.noiseProfileReady = true;
+    snapshot.noisePurity       = smoothedNoisePurity;
+    snapshot.harmonicLossRatio = smoothedHLR;
+    snapshot.residualFlux      = smoothedResFlux;
+    std::copy (bandReductionDB.begin(), bandReductionDB.end(), snapshot.bandReductionDB);
+    snapshot.tonalBinCount     = tonalBinCount;
+    snapshot.droppedFrames     = droppedFrames.load (std::memory_order_relaxed);
+    snapshot.version           = ++snapshotVersion;
+
+    owner.displaySnapshots.publish();
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+    Hisstory – AnalysisWorker.h
+
+    Background thread that turns the engine's display frames into editor
+    snapshots, so that metering costs the audio thread one copy per frame.
+      • The audio thread pushes a compact record (magnitudes, final gains,
+        stationarity and the noise profile) into a wait-free SPSC FIFO and
+        wakes a parked worker through a WorkerWakeup, which never takes a
+        lock – the low-priority worker cannot hold up the audio thread.
+      • The worker derives the display spectra and all quality metrics –
+        Noise Purity, Harmonic Loss, Residual Flux, per-band reduction and
+        the tonal-bin count – and is the only writer of the processor's
+        display snapshots.
+      • If the FIFO is full the frame is dropped, never waited for; the
+        drop count is published with every snapshot.
+  ==============================================================================
+*/
+
+#pragma once
+#include "PluginProcessor.h"
+#include "WorkerWakeup.h"
+
+//==============================================================================
+class HisstoryAudioProcessor::AnalysisWorker : private juce::Thread
+{
+public:
+    /** Record flags. */
+    enum : uint32_t
+    {
+        hasSpectrum  = 1u << 0,    // mags / gains / stationarity are valid
+        bypassed     = 1u << 1,    // draw output = input
+        resetMetrics = 1u << 2     // adaptive profile restarted
+    };
+
+    explicit AnalysisWorker (HisstoryAudioProcessor& processor);
+    ~AnalysisWorker() override;
+
+    /** Stops the thread, sizes the FIFO for this FFT size, resets every
+        metric and restarts.  Not real-time safe. */
+    void prepare (int fftSize);
+
+    /** Stops the thread.  Not real-time safe. */
+    void stop();
+
+    /** Producer side (audio thread, or prepareToPlay while it is stopped).
+        Copies one frame of numBins values per array; mags, gains and
+        stationarity may be null when hasSpectrum is not set.  Never blocks
+        or locks: returns false, and counts a drop, if the FIFO is full. */
+    bool push (const float* mags, const float* gains, const float* stationarity,
+               const float* noiseProfile, uint32_t flags) noexcept;
+
+    /** Blocks until every pushed frame has been analysed and published, or
+        the timeout expires.  For tests and offline hosts. */
+    bool waitUntilIdle (int timeoutMs) const;
+
+    uint64_t getNumDroppedFrames() const noexcept { return droppedFrames.load (std::memory_order_relaxed); }
+
+private:
+    void run() override;
+    void analyse (const float* slot, uint32_t flags);
+
+    HisstoryAudioProcessor& owner;
+
+    //==========================================================================
+    //  SPSC record FIFO: numSlots records of four numBins-long arrays
+    //==========================================================================
+    static constexpr int numSlots = 8;     // 7 usable
+
+    juce::AbstractFifo                fifo { numSlots };
+    std::vector<float>                slotData;
+    std::array<uint32_t, numSlots>    slotFlags {};
+    int                               fftSize = 0;
+    int                               numBins = 0;
+
+    std::atomic<uint64_t> pushedFrames   { 0 };
+    std::atomic<uint64_t> analysedFrames { 0 };
+    std::atomic<uint64_t> droppedFrames  { 0 };
+
+    WorkerWakeup          wakeUp;
+
+    //==========================================================================
+    //  Worker-thread state
+    //==========================================================================
+    std::vector<float> inputSpectrumDB, outputSpectrumDB;   // engine resolution
+    std::vector<float> prevResidualMag;
+    std::vector<char>  isTonal;
+    std::array<int, numBands + 1> bandEdges {};             // first bin of each band, then numBins
+
+    float smoothedNoisePurity = 0.5f;
+    float smoothedHLR         = 1.0f;
+    float smoothedResFlux     = 0.0f;
+    std::array<float, numBands> bandReductionDB {};
+    int   tonalBinCount       = 0;
+
+    uint64_t snapshotVersion  = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (AnalysisWorker)
+};
@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+    Hisstory – BatchRenderer.cpp
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include <algorithm>
+#include <deque>
+#include <memory>
+
+//==============================================================================
+//  Per-worker job deque: the owner takes from the front (its longest job),
+//  thieves take from the back (the victim's shortest).
+//==============================================================================
+struct BatchRenderer::Queue
+{
+    bool takeFront (int& job)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (jobs.empty())
+            return false;
+
+        job = jobs.front();
+        jobs.pop_front();
+        return true;
+    }
+
+    bool takeBack (int& job)
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (jobs.empty())
+            return false;
+
+        job = jobs.back();
+        jobs.pop_back();
+        return true;
+    }
+
+    size_t size() const
+    {
+        const juce::ScopedLock sl (lock);
+        return jobs.size();
+    }
+
+    juce::CriticalSection lock;
+    std::deque<int> jobs;
+};
+
+//==============================================================================
+//  State shared by the workers of one render() call
+//==============================================================================
+namespace
+{
+    struct BatchState
+    {
+        const OfflineRenderer& renderer;
+        const std::vector<BatchRenderer::Job>& jobs;
+        std::vector<BatchRenderer::JobResult>& results;
+        const BatchRenderer::ProgressCallback& progress;
+
+        juce::CriticalSection progressLock;
+        int numDone = 0;
+    };
+}
+
+class BatchRenderer::Worker : public juce::Thread
+{
+public:
+    Worker (int workerIndex, std::vector<Queue>& allQueues, BatchState& batchState)
+        : juce::Thread ("Hisstory batch worker"),
+          index (workerIndex), queues (allQueues), state (batchState)
+    {
+    }
+
+    void run() override
+    {
+        for (int job; takeJob (job);)
+        {
+            auto& r = state.results[static_cast<size_t> (job)];
+            r.job    = state.jobs[static_cast<size_t> (job)];
+            r.worker = index;
+            r.result = state.renderer.render (r.job.input, r.job.output, r.stats);
+
+            const juce::ScopedLock sl (state.progressLock);
+            ++state.numDone;
+
+            if (state.progress)
+                state.progress (r, state.numDone, static_cast<int> (state.jobs.size()));
+        }
+    }
+
+private:
+    /** Own queue first, then the back of the fullest other queue.  Nothing
+        is added once the workers start, so all queues empty means done. */
+    bool takeJob (int& job)
+    {
+        if (queues[static_cast<size_t> (index)].takeFront (job))
+            return true;
+
+        for (;;)
+        {
+            Queue* victim = nullptr;
+            size_t victimSize = 0;
+
+            for (auto& q : queues)
+            {
+                const auto n = q.size();
+
+                if (n > victimSize)
+                {
+                    victim     = &q;
+                    victimSize = n;
+                }
+            }
+
+            if (victim == nullptr)
+                return false;
+
+            if (victim->takeBack (job))
+                return true;
+        }
+    }
+
+    const int index;
+    std::vector<Queue>& queues;
+    BatchState& state;
+};
+
+//==============================================================================
+BatchRenderer::BatchRenderer (const OfflineRenderer::Settings& settings, int threads)
+    : renderer (settings),
+      numThreads (threads > 0 ? threads : juce::SystemStats::getNumCpus())
+{
+}
+
+juce::int64 BatchRenderer::estimateWork (const juce::File& input)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+    return reader != nullptr ? reader->lengthInSamples * static_cast<juce::int64> (reader->numChannels) : 0;
+}
+
+std::vector<BatchRenderer::JobResult> BatchRenderer::render (const std::vector<Job>& jobs,
+                                                             ProgressCallback progress) const
+{
+    std::vector<JobResult> results (jobs.size());
+
+    if (jobs.empty())
+        return results;
+
+    // ── Longest first, dealt round-robin ─────────────────────────────────────
+    std::vector<juce::int64> work;
+    std::vector<int> order;
+
+    for (const auto& job : jobs)
+    {
+        order.push_back (static_cast<int> (work.size()));
+        work.push_back (estimateWork (job.input));
+    }
+
+    std::stable_sort (order.begin(), order.end(),
+                      [&] (int a, int b) { return work[static_cast<size_t> (a)] > work[static_cast<size_t> (b)]; });
+
+    const int numWorkers = std::min (numThreads, static_cast<int> (jobs.size()));
+    std::vector<Queue> queues (static_cast<size_t> (numWorkers));
+
+    for (size_t i = 0; i < order.size(); ++i)
+        queues[i % queues.size()].jobs.push_back (order[i]);
+
+    // ── Run ──────────────────────────────────────────────────────────────────
+    BatchState state { renderer, jobs, results, progress, {}, 0 };
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.push_back (std::make_unique<Worker> (i, queues, state));
+
+    for (auto& w : workers)
+        w->startThread();
+
+    for (auto& w : workers)
+        w->waitForThreadToExit (-1);
+
+    return results;
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+    Hisstory – BatchRenderer.h
+
+    Renders many files through OfflineRenderer on a pool of worker threads.
+      • Each worker renders one file at a time with its own
+        HisstoryAudioProcessor, built fresh for the file, so no noise
+        profile or other state carries from one file to the next and every
+        output is identical whatever the thread count or schedule.
+      • Jobs are ordered longest first (channels × samples, read from the
+        file headers) and dealt round-robin into per-worker deques.  A
+        worker takes from the front of its own deque and, once that is
+        empty, steals from the back of the fullest other one, so long files
+        start early and short ones fill the gaps at the end.
+      • Results come back in job order, not completion order.
+  ==============================================================================
+*/
+
+#pragma once
+#include "OfflineRenderer.h"
+#include <functional>
+#include <vector>
+
+//==============================================================================
+class BatchRenderer
+{
+public:
+    struct Job
+    {
+        juce::File input, output;
+    };
+
+    struct JobResult
+    {
+        Job                     job;
+        juce::Result            result = juce::Result::ok();
+        OfflineRenderer::Stats  stats;
+        int                     worker = -1;
+    };
+
+    /** Called on the worker that finished the job, one call at a time;
+        numDone counts this job. */
+    using ProgressCallback = std::function<void (const JobResult&, int numDone, int numJobs)>;
+
+    /** numThreads ≤ 0 uses one worker per CPU. */
+    BatchRenderer (const OfflineRenderer::Settings&, int numThreads);
+
+    int getNumThreads() const noexcept { return numThreads; }
+
+    /** Renders every job and returns one result per job, in job order.
+        Blocks until all have finished. */
+    std::vector<JobResult> render (const std::vector<Job>& jobs, ProgressCallback progress = {}) const;
+
+    /** Channels × samples of an audio file, from its header; 0 if it cannot
+        be opened (the render then reports the error). */
+    static juce::int64 estimateWork (const juce::File& input);
+
+private:
+    class Worker;
+    struct Queue;
+
+    const OfflineRenderer renderer;
+    const int numThreads;
+
+    JUCE_DECLARE_NON_COPYABLE (BatchRenderer)
+};
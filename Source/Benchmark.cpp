@@ -7,16 +7,36 @@
       2. Processes each through Hisstory (internal) and RX 11 Voice De-noise (VST3)
       3. Writes WAV outputs to benchmark_output/
       4. Computes and prints objective quality metrics
+
+    Micro-benchmark modes (no audio files needed):
+      Benchmark --kernels   staged vs tiled per-bin frame update at each FFT size
+      Benchmark --channels  2–16 channel scaling, inline vs worker pool
+      Benchmark --precision float vs double processBlock vs host-side conversion
+      Benchmark --bypass    engaged vs settled bypass, with and without tracking
+      Benchmark --silence   music vs digital silence vs −125 dBFS noise
+      Benchmark --unity     loud material with and without the unity-gain shortcut
+      Benchmark --fft       per-backend FFT cost at each order, and what auto picks
+      Benchmark --timing    per-stage callback timing, histogram and deadline misses
+      Benchmark --segments  segmented offline render: speed-up and difference
+                            from a serial render by thread count and pre-roll
+      Benchmark --offline-stft  three-phase offline STFT: speed-up by thread
+                            count and FFT size, output checked bit-identical
   ==============================================================================
 */
 
 #include "PluginProcessor.h"
+#include "SpectralKernels.h"
+#include "FftBackend.h"
+#include "OfflineRenderer.h"
 #include <JuceHeader.h>
 #include <cstdio>
 #include <cmath>
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <random>
 
 //==============================================================================
 //  Metrics
@@ -322,11 +342,896 @@ static bool writeWavFile (const juce::File& file,
     return true;
 }
 
+//==============================================================================
+//  --kernels: staged vs tiled per-bin frame update at each FFT size
+//==============================================================================
+struct KernelBenchData
+{
+    const int numBins;
+
+    std::vector<float> fftSource, fftData, noiseProfile, runningMean, runningMeanSq,
+                       prevGain, threshold, noiseBias, mags, magsSq, stationarity, isPeak,
+                       alphaScale, gains;
+
+    explicit KernelBenchData (int fftOrder)
+        : numBins ((1 << fftOrder) / 2 + 1),
+          fftSource (static_cast<size_t> (2 << fftOrder)), fftData (fftSource.size()),
+          noiseProfile (numBins, 0.02f), runningMean (numBins, 0.05f),
+          runningMeanSq (numBins, 0.004f), prevGain (numBins, 1.0f),
+          threshold (numBins, 0.2f), noiseBias (numBins, 1.8f),
+          mags (numBins), magsSq (numBins),
+          stationarity (numBins), isPeak (numBins + 2), alphaScale (numBins),
+          gains (numBins)
+    {
+        std::mt19937 rng (7);
+        std::normal_distribution<float> dist (0.0f, 0.05f);
+        for (auto& v : fftSource)
+            v = dist (rng);
+    }
+
+    /** Bytes one frame update touches: the bins (re, im) plus the twelve
+        per-bin arrays. */
+    size_t workingSetBytes() const noexcept
+    {
+        return (2 + 12) * static_cast<size_t> (numBins) * sizeof (float);
+    }
+
+    HisstoryKernels::FrameContext context()
+    {
+        HisstoryKernels::FrameContext c;
+        c.fftData = fftData.data();           c.noiseProfile = noiseProfile.data();
+        c.runningMean = runningMean.data();   c.runningMeanSq = runningMeanSq.data();
+        c.prevGain = prevGain.data();         c.perBinThreshold = threshold.data();
+        c.noiseBias = noiseBias.data();
+        c.mags = mags.data();                 c.magsSq = magsSq.data();
+        c.stationarity = stationarity.data(); c.isPeak = isPeak.data();
+        c.alphaScale = alphaScale.data();     c.gains = gains.data();
+        c.alpha = 2.25f;
+        c.spectralFloor = 0.001f;  c.releaseCoeff = 0.5f;  c.adaptive = true;
+        c.numBins = numBins;
+        return c;
+    }
+};
+
+// Sweeps every engine FFT size, so the working set grows from about the
+// size of L1d (order 10, 28 KB) to beyond a typical per-core L2 (order 14,
+// 450 KB): tiling can only pay off where the staged passes stop fitting.
+static int runKernelBenchmark()
+{
+    constexpr int numRuns        = 7;
+    constexpr int binsPerRunSize = 1 << 22;     // ~same run time at every order
+    constexpr int tileSizes[]    = { 128, 256, 512, 1024 };
+    constexpr int numDrivers     = 1 + static_cast<int> (std::size (tileSizes));   // staged, then each tile
+
+    auto runDriver = [&] (int driver, const HisstoryKernels::FrameContext& c)
+    {
+        if (driver == 0)
+            HisstoryKernels::processFrameStaged (c);
+        else
+            HisstoryKernels::processFrameTiled (c, tileSizes[driver - 1]);
+    };
+
+    std::printf ("======================================================\n");
+    std::printf ("  Per-bin frame update: staged vs tiled, by FFT size\n");
+    std::printf ("  (speed-up of each tile size over staged; >1 = tiled wins)\n");
+    std::printf ("======================================================\n");
+    std::printf ("  %-6s %6s %8s %10s", "Order", "Bins", "Set KB", "Staged ns");
+
+    for (int tileBins : tileSizes)
+        std::printf ("  %12s ", ("Tiled " + juce::String (tileBins)).toRawUTF8());
+    std::printf ("\n");
+
+    bool allIdentical = true;
+
+    for (int order = HisstoryAudioProcessor::minFftOrder; order <= HisstoryAudioProcessor::maxFftOrder; ++order)
+    {
+        std::vector<std::unique_ptr<KernelBenchData>> data;
+        for (int d = 0; d < numDrivers; ++d)
+            data.push_back (std::make_unique<KernelBenchData> (order));
+
+        const int numFrames = std::max (1, binsPerRunSize / data[0]->numBins);
+
+        // Drivers alternate within each run so clock and cache drift hit
+        // them alike; best-of-N ns/frame, after one untimed warm-up run.
+        std::vector<double> bestNs (numDrivers, 1.0e30);
+
+        for (int run = 0; run <= numRuns; ++run)
+        {
+            for (int d = 0; d < numDrivers; ++d)
+            {
+                auto& bench = *data[(size_t) d];
+                const auto ctx = bench.context();
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                for (int f = 0; f < numFrames; ++f)
+                {
+                    std::memcpy (bench.fftData.data(), bench.fftSource.data(), bench.fftSource.size() * sizeof (float));
+                    runDriver (d, ctx);
+                }
+
+                const auto ticks = juce::Time::getHighResolutionTicks() - start;
+                if (run > 0)
+                    bestNs[(size_t) d] = std::min (bestNs[(size_t) d],
+                                                   juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / numFrames);
+            }
+        }
+
+        const auto& staged = *data[0];
+        std::printf ("  %-6d %6d %8.0f %10.0f", order, staged.numBins,
+                     (double) staged.workingSetBytes() / 1024.0, bestNs[0]);
+
+        for (int d = 1; d < numDrivers; ++d)
+        {
+            const auto& tiled = *data[(size_t) d];
+            const bool identical = staged.fftData == tiled.fftData
+                                && staged.noiseProfile == tiled.noiseProfile
+                                && staged.prevGain == tiled.prevGain;
+            allIdentical = allIdentical && identical;
+
+            std::printf ("  %11.2fx%s", bestNs[0] / bestNs[(size_t) d], identical ? " " : "!");
+        }
+
+        std::printf ("\n");
+    }
+
+    std::printf ("  Results identical: %s\n", allIdentical ? "yes" : "NO (! marks a mismatch)");
+    std::printf ("  The engine uses staged unless setUseTiledFrameUpdate (true) is called.\n");
+
+    return allIdentical ? 0 : 1;
+}
+
+//==============================================================================
+//  --channels: multichannel throughput, inline vs channel worker pool
+//==============================================================================
+static double timeMultichannelRun (int numChannels, int workerThreads,
+                                   const juce::AudioBuffer<float>& source, int& threadsUsed)
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int    blockSize  = 512;
+
+    HisstoryAudioProcessor proc;
+    proc.setChannelWorkerThreads (workerThreads);
+    proc.setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+    proc.prepareToPlay (sampleRate, blockSize);
+    threadsUsed = proc.getNumChannelWorkerThreads();
+
+    juce::AudioBuffer<float> block (numChannels, blockSize);
+    juce::MidiBuffer midi;
+    const int numBlocks = source.getNumSamples() / blockSize;
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            block.copyFrom (ch, 0, source, ch % source.getNumChannels(), b * blockSize, blockSize);
+
+        proc.processBlock (block, midi);
+    }
+
+    const auto ticks = juce::Time::getHighResolutionTicks() - start;
+    proc.releaseResources();
+    return juce::Time::highResolutionTicksToSeconds (ticks);
+}
+
+static int runChannelScalingBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 10.0;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+
+    // Two decorrelated noise + tone channels, reused round-robin.
+    juce::AudioBuffer<float> source (2, numSamples);
+    std::mt19937 rng (11);
+    std::normal_distribution<float> noise (0.0f, 0.01f);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* d = source.getWritePointer (ch);
+        for (int i = 0; i < numSamples; ++i)
+            d[i] = 0.1f * std::sin (2.0f * juce::MathConstants<float>::pi
+                                    * (440.0f + 110.0f * ch) * i / static_cast<float> (sampleRate))
+                 + noise (rng);
+    }
+
+    const int cpus = juce::SystemStats::getNumCpus();
+
+    std::printf ("======================================================\n");
+    std::printf ("  Channel scaling: %.0f s at 44.1 kHz, %d CPUs\n", seconds, cpus);
+    std::printf ("======================================================\n");
+    std::printf ("  %-9s %12s %10s %9s %12s %9s\n",
+                 "Channels", "inline (s)", "x realtime", "workers", "pool (s)", "speed-up");
+
+    for (int numChannels : { 2, 4, 6, 8, 12, 16 })
+    {
+        // One transform unit per channel pair; the audio thread takes one.
+        const int units   = (numChannels + 1) / 2;
+        const int workers = std::max (0, std::min (units, cpus) - 1);
+
+        int inlineThreads = 0, poolThreads = 0;
+        const double inlineSec = timeMultichannelRun (numChannels, 0, source, inlineThreads);
+        const double poolSec   = timeMultichannelRun (numChannels, workers, source, poolThreads);
+
+        std::printf ("  %-9d %12.3f %10.1f %9d %12.3f %8.2fx\n",
+                     numChannels, inlineSec, seconds / inlineSec,
+                     poolThreads, poolSec, inlineSec / poolSec);
+    }
+
+    // Above 1 only with cores to spare; on a loaded machine it shows the cost.
+    if (cpus < 2)
+        std::printf ("  One CPU: no workers are started, so both columns time the audio thread alone.\n");
+
+    return 0;
+}
+
+//==============================================================================
+//  --precision: 64-bit processBlock vs the float path it replaces
+//  A host without double support has to round its buffers to float and back
+//  around every call; the "converted" column times that round trip.
+//==============================================================================
+enum class PrecisionPath { floatPath, doublePath, convertedPath };
+
+static double timePrecisionRun (PrecisionPath path, const juce::AudioBuffer<double>& source)
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int    blockSize  = 512;
+    const int numChannels = source.getNumChannels();
+
+    HisstoryAudioProcessor proc;
+    proc.setProcessingPrecision (path == PrecisionPath::doublePath ? juce::AudioProcessor::doublePrecision
+                                                                   : juce::AudioProcessor::singlePrecision);
+    proc.setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+    proc.prepareToPlay (sampleRate, blockSize);
+
+    juce::AudioBuffer<double> hostBlock (numChannels, blockSize);
+    juce::AudioBuffer<float>  floatBlock (numChannels, blockSize);
+    juce::MidiBuffer midi;
+    const int numBlocks = source.getNumSamples() / blockSize;
+
+    // The float path starts from float data so that it times processing only.
+    juce::AudioBuffer<float> floatSource;
+    floatSource.makeCopyOf (source);
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        if (path == PrecisionPath::floatPath)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                floatBlock.copyFrom (ch, 0, floatSource, ch, b * blockSize, blockSize);
+
+            proc.processBlock (floatBlock, midi);
+            continue;
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            hostBlock.copyFrom (ch, 0, source, ch, b * blockSize, blockSize);
+
+        if (path == PrecisionPath::doublePath)
+        {
+            proc.processBlock (hostBlock, midi);
+        }
+        else
+        {
+            floatBlock.makeCopyOf (hostBlock, true);
+            proc.processBlock (floatBlock, midi);
+            hostBlock.makeCopyOf (floatBlock, true);
+        }
+    }
+
+    const auto ticks = juce::Time::getHighResolutionTicks() - start;
+    proc.releaseResources();
+    return juce::Time::highResolutionTicksToSeconds (ticks);
+}
+
+static int runPrecisionBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 10.0;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+
+    juce::AudioBuffer<double> source (2, numSamples);
+    std::mt19937 rng (13);
+    std::normal_distribution<double> noise (0.0, 0.01);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* d = source.getWritePointer (ch);
+        for (int i = 0; i < numSamples; ++i)
+            d[i] = 0.1 * std::sin (2.0 * juce::MathConstants<double>::pi
+                                   * (440.0 + 110.0 * ch) * i / sampleRate)
+                 + noise (rng);
+    }
+
+    std::printf ("======================================================\n");
+    std::printf ("  Sample precision: %.0f s stereo at 44.1 kHz\n", seconds);
+    std::printf ("======================================================\n");
+    std::printf ("  %-28s %10s %11s %9s\n", "Path", "time (s)", "x realtime", "vs float");
+
+    const double floatSec = timePrecisionRun (PrecisionPath::floatPath, source);
+
+    const std::pair<const char*, PrecisionPath> paths[]
+    {
+        { "float processBlock",          PrecisionPath::floatPath },
+        { "double processBlock",         PrecisionPath::doublePath },
+        { "double -> float -> double",   PrecisionPath::convertedPath },
+    };
+
+    for (const auto& [label, path] : paths)
+    {
+        const double sec = path == PrecisionPath::floatPath ? floatSec : timePrecisionRun (path, source);
+        std::printf ("  %-28s %10.3f %11.1f %8.2fx\n", label, sec, seconds / sec, sec / floatSec);
+    }
+
+    return 0;
+}
+
+//==============================================================================
+//  --bypass: cost of a bypassed instance
+//  Once the crossfade has settled only the delay line runs, plus a forward
+//  FFT every few hops when the noise tracker is kept alive.
+//==============================================================================
+static double timeStereoRun (const juce::AudioBuffer<float>& source, bool bypassed, bool trackNoise,
+                             bool skipUnityGain = true,
+                             HisstoryAudioProcessor::FrameStatistics* stats = nullptr)
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int    blockSize  = 512;
+    const int numChannels = source.getNumChannels();
+
+    HisstoryAudioProcessor proc;
+    proc.setTrackNoiseWhileBypassed (trackNoise);
+    proc.setSkipUnityGainFrames (skipUnityGain);
+    proc.apvts.getParameter ("bypass")->setValueNotifyingHost (bypassed ? 1.0f : 0.0f);
+    proc.setPlayConfigDetails (numChannels, numChannels, sampleRate, blockSize);
+    proc.prepareToPlay (sampleRate, blockSize);
+
+    juce::AudioBuffer<float> block (numChannels, blockSize);
+    juce::MidiBuffer midi;
+    const int numBlocks = source.getNumSamples() / blockSize;
+
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            block.copyFrom (ch, 0, source, ch, b * blockSize, blockSize);
+
+        proc.processBlock (block, midi);
+    }
+
+    const auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+    if (stats != nullptr)
+        *stats = proc.getFrameStatistics();
+
+    proc.releaseResources();
+    return juce::Time::highResolutionTicksToSeconds (ticks);
+}
+
+static int runBypassBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 10.0;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+
+    juce::AudioBuffer<float> source (2, numSamples);
+    std::mt19937 rng (17);
+    std::normal_distribution<float> noise (0.0f, 0.01f);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* d = source.getWritePointer (ch);
+        for (int i = 0; i < numSamples; ++i)
+            d[i] = 0.1f * std::sin (2.0f * juce::MathConstants<float>::pi
+                                    * (440.0f + 110.0f * ch) * i / static_cast<float> (sampleRate))
+                 + noise (rng);
+    }
+
+    std::printf ("======================================================\n");
+    std::printf ("  Bypass cost: %.0f s stereo at 44.1 kHz\n", seconds);
+    std::printf ("======================================================\n");
+    std::printf ("  %-28s %10s %11s %9s\n", "State", "time (s)", "x realtime", "vs active");
+
+    const double activeSec = timeStereoRun (source, false, true);
+
+    const struct { const char* label; bool bypassed; bool track; } states[]
+    {
+        { "active",                      false, true  },
+        { "bypassed, tracking noise",    true,  true  },
+        { "bypassed, delay line only",   true,  false },
+    };
+
+    for (const auto& state : states)
+    {
+        const double sec = state.bypassed ? timeStereoRun (source, true, state.track) : activeSec;
+        std::printf ("  %-28s %10.3f %11.1f %8.2fx\n", state.label, sec, seconds / sec, sec / activeSec);
+    }
+
+    return 0;
+}
+
+//==============================================================================
+//  --silence: frames below −100 dBFS skip the STFT
+//==============================================================================
+static int runSilenceBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 10.0;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+
+    juce::AudioBuffer<float> music (2, numSamples), silence (2, numSamples), quiet (2, numSamples);
+    std::mt19937 rng (19);
+    std::normal_distribution<float> noise (0.0f, 0.01f);
+    std::normal_distribution<float> floorNoise (0.0f, 5.6e-7f);    // ≈ −125 dBFS
+
+    silence.clear();
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* m = music.getWritePointer (ch);
+        auto* q = quiet.getWritePointer (ch);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            m[i] = 0.1f * std::sin (2.0f * juce::MathConstants<float>::pi
+                                    * (440.0f + 110.0f * ch) * i / static_cast<float> (sampleRate))
+                 + noise (rng);
+            q[i] = floorNoise (rng);
+        }
+    }
+
+    std::printf ("======================================================\n");
+    std::printf ("  Silent frames: %.0f s stereo at 44.1 kHz\n", seconds);
+    std::printf ("======================================================\n");
+    std::printf ("  %-28s %10s %11s %9s\n", "Input", "time (s)", "x realtime", "vs music");
+
+    const double musicSec = timeStereoRun (music, false, true);
+
+    const std::pair<const char*, const juce::AudioBuffer<float>*> inputs[]
+    {
+        { "sine + noise",       &music },
+        { "digital silence",    &silence },
+        { "-125 dBFS noise",    &quiet },
+    };
+
+    for (const auto& [label, source] : inputs)
+    {
+        const double sec = source == &music ? musicSec : timeStereoRun (*source, false, true);
+        std::printf ("  %-28s %10.3f %11.1f %8.2fx\n", label, sec, seconds / sec, sec / musicSec);
+    }
+
+    return 0;
+}
+
+//==============================================================================
+//  --unity: frames at unity gain skip the inverse FFT
+//  Loud broadband bursts over a quiet hiss floor; the rate is the share of
+//  frames that took the shortcut.
+//==============================================================================
+static int runUnityGainBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 10.0;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+
+    juce::AudioBuffer<float> source (2, numSamples);
+    std::mt19937 rng (23);
+    std::normal_distribution<float> noise (0.0f, 1.0f);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* d = source.getWritePointer (ch);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const bool burst = (i / static_cast<int> (sampleRate)) % 2 == 1;
+            d[i] = noise (rng) * (burst ? 0.15f : 0.0005f);
+        }
+    }
+
+    std::printf ("======================================================\n");
+    std::printf ("  Unity-gain frames: %.0f s stereo at 44.1 kHz\n", seconds);
+    std::printf ("======================================================\n");
+    std::printf ("  %-28s %10s %11s %9s %9s\n", "Path", "time (s)", "x realtime", "vs full", "unity");
+
+    HisstoryAudioProcessor::FrameStatistics fullStats, skipStats;
+    const double fullSec = timeStereoRun (source, false, true, false, &fullStats);
+    const double skipSec = timeStereoRun (source, false, true, true,  &skipStats);
+
+    const struct { const char* label; double sec; HisstoryAudioProcessor::FrameStatistics stats; } paths[]
+    {
+        { "inverse FFT every frame",   fullSec, fullStats },
+        { "unity-gain shortcut",       skipSec, skipStats },
+    };
+
+    for (const auto& path : paths)
+        std::printf ("  %-28s %10.3f %11.1f %8.2fx %8.1f%%\n", path.label, path.sec, seconds / path.sec,
+                     path.sec / fullSec,
+                     100.0 * (double) path.stats.unityGain / (double) std::max<uint64_t> (1, path.stats.total));
+
+    return 0;
+}
+
+//==============================================================================
+//  --fft: FFT backends per order
+//  One hop's worth of transforms for a stereo pair: a real round trip (the
+//  mono path) and a complex round trip (the paired path).
+//==============================================================================
+static int runFftBackendBenchmark()
+{
+    constexpr int numRuns = 5;
+    const FftBackend::Kind kinds[] { FftBackend::Kind::juce, FftBackend::Kind::simd, FftBackend::Kind::reference };
+
+    std::printf ("======================================================\n");
+    std::printf ("  FFT backends: real + complex round trip, us per call\n");
+    std::printf ("======================================================\n");
+    std::printf ("  %-6s %10s %10s %10s   %s\n", "Size", "juce", "simd", "reference", "auto");
+
+    for (int order = HisstoryAudioProcessor::minFftOrder; order <= HisstoryAudioProcessor::maxFftOrder; ++order)
+    {
+        const int n = 1 << order;
+        const int iterations = std::max (16, (1 << 22) / n);
+
+        std::vector<float> real (2 * n);
+        std::vector<std::complex<float>> complexIn (n), complexOut (n);
+        std::mt19937 rng (order);
+        std::uniform_real_distribution<float> dist (-1.0f, 1.0f);
+        for (auto& c : complexIn)
+            c = { dist (rng), dist (rng) };
+
+        std::printf ("  %-6d", n);
+
+        for (const auto kind : kinds)
+        {
+            auto fft = FftBackend::create (order, kind);
+            const float scale = 1.0f / fft->getRoundTripGain();
+            double best = 1.0e30;
+
+            // Best-of-N, after one untimed warm-up run.
+            for (int run = 0; run <= numRuns; ++run)
+            {
+                for (int i = 0; i < n; ++i)
+                    real[i] = complexIn[i].real();
+
+                const auto start = juce::Time::getHighResolutionTicks();
+
+                for (int it = 0; it < iterations; ++it)
+                {
+                    fft->forwardReal (real.data());
+                    fft->inverseReal (real.data());
+                    fft->performComplex (complexIn.data(), complexOut.data(), false);
+                    fft->performComplex (complexOut.data(), complexIn.data(), true);
+                    juce::FloatVectorOperations::multiply (real.data(), scale, n);
+                    juce::FloatVectorOperations::multiply (reinterpret_cast<float*> (complexIn.data()), scale, 2 * n);
+                }
+
+                const auto ticks = juce::Time::getHighResolutionTicks() - start;
+                if (run > 0)
+                    best = std::min (best, juce::Time::highResolutionTicksToSeconds (ticks) * 1.0e6 / iterations);
+            }
+
+            std::printf (" %10.2f", best);
+        }
+
+        std::printf ("   %s\n", FftBackend::getName (FftBackend::selectFastest (order)));
+    }
+
+    return 0;
+}
+
+//==============================================================================
+//  --timing: per-stage cost and callback-time distribution as the processor
+//  reports it (getTimingStatistics), for the STFT configurations that load
+//  the audio thread differently.
+//==============================================================================
+static int runTimingBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 10.0;
+    constexpr int    blockSize  = 512;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+    const int numBlocks  = numSamples / blockSize;
+
+    juce::AudioBuffer<float> source (2, numSamples);
+    std::mt19937 rng (29);
+    std::normal_distribution<float> noise (0.0f, 0.01f);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* d = source.getWritePointer (ch);
+        for (int i = 0; i < numSamples; ++i)
+            d[i] = 0.1f * std::sin (2.0f * juce::MathConstants<float>::pi
+                                    * (440.0f + 110.0f * ch) * i / static_cast<float> (sampleRate))
+                 + noise (rng);
+    }
+
+    if constexpr (! ProcessTiming::enabled)
+    {
+        std::printf ("Timing is compiled out (HISSTORY_ENABLE_TIMING=0)\n");
+        return 1;
+    }
+
+    const struct { const char* label; int fftOrder; bool lowLatency; } configs[]
+    {
+        { "4096-point",               12, false },
+        { "16384-point",              14, false },
+        { "4096-point, low latency",  12, true  },
+    };
+
+    for (const auto& config : configs)
+    {
+        HisstoryAudioProcessor proc (config.fftOrder);
+        proc.setLowLatencyMode (config.lowLatency);
+        proc.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+        proc.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> block (2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                block.copyFrom (ch, 0, source, ch, b * blockSize, blockSize);
+
+            proc.processBlock (block, midi);
+        }
+
+        const auto stats = proc.getTimingStatistics();
+        const double perCallback = 1.0e6 / (double) std::max<uint64_t> (1, stats.callbacks);
+
+        std::printf ("======================================================\n");
+        std::printf ("  %s: %.0f s stereo, %d-sample blocks\n", config.label, seconds, blockSize);
+        std::printf ("======================================================\n");
+        std::printf ("  %-18s %12s %9s\n", "Stage", "us/callback", "share");
+
+        for (int i = 0; i < ProcessTiming::numStages; ++i)
+            std::printf ("  %-18s %12.2f %8.1f%%\n", ProcessTiming::getStageName (i),
+                         stats.stageSeconds[(size_t) i] * perCallback,
+                         100.0 * stats.stageSeconds[(size_t) i] / stats.totalSeconds);
+
+        std::printf ("  %-18s %12.2f   (max %.1f us, budget %.1f us)\n", "callback",
+                     stats.totalSeconds * perCallback, stats.maxSeconds * 1.0e6,
+                     blockSize / sampleRate * 1.0e6);
+        std::printf ("  Deadline misses (> %.0f%% of block): %llu of %llu\n",
+                     100.0 * proc.getDeadlineFraction(),
+                     (unsigned long long) stats.deadlineMisses, (unsigned long long) stats.callbacks);
+
+        std::printf ("  Histogram:");
+        for (int b = 0; b < ProcessTiming::numHistogramBuckets; ++b)
+            if (stats.histogram[(size_t) b] > 0)
+                std::printf ("  %s%g us: %llu", b < ProcessTiming::numHistogramBuckets - 1 ? "<" : ">=",
+                             ProcessTiming::getBucketUpperSeconds (std::min (b, ProcessTiming::numHistogramBuckets - 2)) * 1.0e6,
+                             (unsigned long long) stats.histogram[(size_t) b]);
+        std::printf ("\n");
+
+        proc.releaseResources();
+    }
+
+    return 0;
+}
+
+//==============================================================================
+//  --segments: segmented offline render vs serial
+//==============================================================================
+static int runSegmentBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 300.0;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+
+    // Slowly swelling two-tone material over hiss, so both the noise
+    // tracker and the stationarity statistics have something to follow.
+    juce::AudioBuffer<float> source (2, numSamples);
+    std::mt19937 rng (31);
+    std::normal_distribution<float> noise (0.0f, 0.005f);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* d = source.getWritePointer (ch);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float t     = static_cast<float> (i / sampleRate);
+            const float swell = 0.5f + 0.5f * std::sin (juce::MathConstants<float>::twoPi * 0.03f * t);
+            d[i] = 0.1f * swell * std::sin (juce::MathConstants<float>::twoPi * (330.0f + 110.0f * ch) * t)
+                 + noise (rng);
+        }
+    }
+
+    const auto dir = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                         .getChildFile ("hisstory-segment-benchmark");
+    dir.deleteRecursively();
+    dir.createDirectory();
+
+    const auto input  = dir.getChildFile ("input.wav");
+    const auto serial = dir.getChildFile ("serial.wav");
+    const auto output = dir.getChildFile ("segmented.wav");
+
+    if (! writeWavFile (input, source, sampleRate))
+    {
+        std::printf ("Cannot write %s\n", input.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    OfflineRenderer::Settings settings;
+    settings.bitsPerSample  = 32;
+    settings.segmentSeconds = 30.0;
+
+    OfflineRenderer::Stats serialStats;
+    if (auto result = OfflineRenderer (settings).render (input, serial, serialStats); result.failed())
+    {
+        std::printf ("%s\n", result.getErrorMessage().toRawUTF8());
+        return 1;
+    }
+
+    std::printf ("======================================================\n");
+    std::printf ("  Segmented render: %.0f s stereo, %.0f s segments, %d CPUs\n",
+                 seconds, settings.segmentSeconds, juce::SystemStats::getNumCpus());
+    std::printf ("======================================================\n");
+    std::printf ("  %-8s %9s %9s %9s %12s %12s\n", "threads", "pre-roll", "wall s", "speed-up", "diff dBFS", "signal/diff");
+    std::printf ("  %-8s %9s %9.3f %9s %12s %12s\n", "serial", "-", serialStats.totalSeconds, "1.00x", "-", "-");
+
+    const auto run = [&] (int threads, double preRoll)
+    {
+        settings.segmentThreads = threads;
+        settings.preRollSeconds = preRoll;
+
+        OfflineRenderer::Stats stats;
+        OfflineRenderer::Difference diff;
+
+        if (OfflineRenderer (settings).render (input, output, stats).failed()
+             || OfflineRenderer::compare (output, serial, diff).failed())
+        {
+            std::printf ("  %-8d render failed\n", threads);
+            return;
+        }
+
+        std::printf ("  %-8d %8.1fs %9.3f %8.2fx %12.1f %11.1fdB\n", threads, preRoll, stats.totalSeconds,
+                     serialStats.totalSeconds / stats.totalSeconds, diff.rmsDb, diff.signalToDifferenceDb);
+    };
+
+    for (const int threads : { 2, 4, 8, 16 })
+        run (threads, 10.0);
+
+    std::printf ("\n");
+
+    for (const double preRoll : { 0.0, 1.0, 2.0, 5.0, 10.0, 20.0 })
+        run (8, preRoll);
+
+    dir.deleteRecursively();
+    return 0;
+}
+
+//==============================================================================
+//  --offline-stft: three-phase offline STFT vs the real-time path
+//==============================================================================
+static double timeOfflineStftRun (const juce::AudioBuffer<float>& source, int fftOrder, bool lowLatency,
+                                  int offlineThreads, juce::AudioBuffer<float>& output)
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr int    blockSize  = 32768;
+    const int numCh = source.getNumChannels();
+
+    HisstoryAudioProcessor proc;
+    proc.setFftOrder (fftOrder);
+    proc.setLowLatencyMode (lowLatency);
+    proc.setOfflineStftThreads (offlineThreads);
+    proc.setPlayConfigDetails (numCh, numCh, sampleRate, blockSize);
+    proc.prepareToPlay (sampleRate, blockSize);
+
+    output.makeCopyOf (source);
+    juce::MidiBuffer midi;
+    juce::int64 ticks = 0;
+
+    for (int pos = 0; pos < source.getNumSamples(); pos += blockSize)
+    {
+        const int n = std::min (blockSize, source.getNumSamples() - pos);
+        juce::AudioBuffer<float> block (output.getArrayOfWritePointers(), numCh, pos, n);
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        proc.processBlock (block, midi);
+        ticks += juce::Time::getHighResolutionTicks() - start;
+    }
+
+    proc.releaseResources();
+    return juce::Time::highResolutionTicksToSeconds (ticks);
+}
+
+static int runOfflineStftBenchmark()
+{
+    constexpr double sampleRate = 44100.0;
+    constexpr double seconds    = 60.0;
+    const int numSamples = static_cast<int> (sampleRate * seconds);
+
+    juce::AudioBuffer<float> source (2, numSamples);
+    std::mt19937 rng (41);
+    std::normal_distribution<float> noise (0.0f, 0.005f);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        auto* d = source.getWritePointer (ch);
+        for (int i = 0; i < numSamples; ++i)
+            d[i] = 0.1f * std::sin (juce::MathConstants<float>::twoPi * (330.0f + 110.0f * ch)
+                                    * static_cast<float> (i / sampleRate))
+                 + noise (rng);
+    }
+
+    std::printf ("======================================================\n");
+    std::printf ("  Offline three-phase STFT: %.0f s stereo, 32768-sample blocks, %d CPUs\n",
+                 seconds, juce::SystemStats::getNumCpus());
+    std::printf ("======================================================\n");
+    std::printf ("  %-22s %8s %9s %11s %9s %10s\n", "Engine", "threads", "time (s)", "x realtime", "speed-up", "identical");
+
+    bool allIdentical = true;
+
+    struct Config { const char* name; int fftOrder; bool lowLatency; };
+    const Config configs[] = {
+        { "4096",               12, false },
+        { "16384",              14, false },
+        { "4096, low latency",  12, true  },
+    };
+
+    for (const auto& config : configs)
+    {
+        juce::AudioBuffer<float> reference, output;
+        const double realTimeSec = timeOfflineStftRun (source, config.fftOrder, config.lowLatency, 0, reference);
+
+        std::printf ("  %-22s %8s %9.3f %11.1f %9s %10s\n", config.name, "off",
+                     realTimeSec, seconds / realTimeSec, "1.00x", "-");
+
+        for (const int threads : { 1, 2, 4, 8 })
+        {
+            const double sec = timeOfflineStftRun (source, config.fftOrder, config.lowLatency, threads, output);
+
+            bool identical = true;
+            for (int ch = 0; ch < source.getNumChannels(); ++ch)
+                identical = identical && std::memcmp (output.getReadPointer (ch), reference.getReadPointer (ch),
+                                                      sizeof (float) * (size_t) numSamples) == 0;
+
+            allIdentical = allIdentical && identical;
+            std::printf ("  %-22s %8d %9.3f %11.1f %8.2fx %10s\n", "", threads, sec, seconds / sec,
+                         realTimeSec / sec, identical ? "yes" : "NO");
+        }
+    }
+
+    return allIdentical ? 0 : 1;
+}
+
 //==============================================================================
 //  Main
 //==============================================================================
 int main (int argc, char* argv[])
 {
+    if (argc > 1 && juce::String (argv[1]) == "--kernels")
+        return runKernelBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--channels")
+        return runChannelScalingBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--precision")
+        return runPrecisionBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--bypass")
+        return runBypassBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--silence")
+        return runSilenceBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--unity")
+        return runUnityGainBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--fft")
+        return runFftBackendBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--timing")
+        return runTimingBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--segments")
+        return runSegmentBenchmark();
+
+    if (argc > 1 && juce::String (argv[1]) == "--offline-stft")
+        return runOfflineStftBenchmark();
+
     // Initialise JUCE message manager (needed for plugin hosting)
     juce::ScopedJuceInitialiser_GUI init;
 
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+    Hisstory – ChannelWorkerPool.cpp
+  ==============================================================================
+*/
+
+#include "ChannelWorkerPool.h"
+#include "WorkerWakeup.h"
+
+#if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    /** Busy-wait hint: lets a hyper-threaded sibling run and saves power,
+        without giving up the time slice (no system call). */
+    inline void cpuRelax() noexcept
+    {
+       #if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86)
+        _mm_pause();
+       #elif (defined (__aarch64__) || defined (__arm__)) && (defined (__GNUC__) || defined (__clang__))
+        __asm__ __volatile__ ("yield");
+       #endif
+    }
+}
+
+//==============================================================================
+//  Worker thread
+//  Spins briefly after each dispatch so the forward and inverse phases of
+//  a hop (issued back to back, processSpectrum apart) don't each pay for a
+//  wake-up, then parks until the next dispatch wakes it.
+//==============================================================================
+class ChannelWorkerPool::Worker : public juce::Thread
+{
+public:
+    explicit Worker (ChannelWorkerPool& p)
+        : juce::Thread ("Hisstory channel worker"), pool (p) {}
+
+    void run() override
+    {
+        // Denormals flushed as on the audio thread (processBlock), so a
+        // task's result doesn't depend on which thread ran it.
+        juce::ScopedNoDenormals noDenormals;
+
+        const auto spinTicks = juce::Time::getHighResolutionTicksPerSecond() * spinMicroseconds / 1000000;
+        uint32_t seenGeneration = generationOf (pool.claimState.load());
+
+        while (! threadShouldExit())
+        {
+            uint32_t latest = generationOf (pool.claimState.load (std::memory_order_acquire));
+
+            if (latest == seenGeneration)
+            {
+                const auto spinEnd = juce::Time::getHighResolutionTicks() + spinTicks;
+
+                do
+                {
+                    for (int i = 0; i < 64 && latest == seenGeneration; ++i)
+                    {
+                        cpuRelax();
+                        latest = generationOf (pool.claimState.load (std::memory_order_acquire));
+                    }
+                }
+                while (latest == seenGeneration && juce::Time::getHighResolutionTicks() < spinEnd);
+            }
+
+            if (latest == seenGeneration)
+            {
+                // Token first, then the re-check: a dispatch published in
+                // between has already bumped the token, so wait() returns.
+                const auto token = wakeUp.prepareWait();
+
+                if (generationOf (pool.claimState.load()) == seenGeneration && ! threadShouldExit())
+                    wakeUp.wait (token, 100);
+
+                continue;
+            }
+
+            seenGeneration = latest;
+            pool.runTasks (seenGeneration);
+        }
+    }
+
+    WorkerWakeup wakeUp;
+
+private:
+    static constexpr juce::int64 spinMicroseconds = 50;
+    ChannelWorkerPool& pool;
+};
+
+//==============================================================================
+ChannelWorkerPool::ChannelWorkerPool() = default;
+
+ChannelWorkerPool::~ChannelWorkerPool()
+{
+    stop();
+}
+
+void ChannelWorkerPool::start (int numThreads)
+{
+    stop();
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        workers.push_back (std::make_unique<Worker> (*this));
+        workers.back()->startThread (juce::Thread::Priority::highest);
+    }
+}
+
+void ChannelWorkerPool::stop()
+{
+    for (auto& w : workers)
+    {
+        w->signalThreadShouldExit();
+        w->wakeUp.notify();
+    }
+
+    for (auto& w : workers)
+        w->stopThread (1000);
+
+    workers.clear();
+}
+
+//==============================================================================
+//  Dispatch
+//==============================================================================
+void ChannelWorkerPool::run (Task task, void* context, int numTasks) noexcept
+{
+    if (numTasks <= 0)
+        return;
+
+    if (workers.empty() || numTasks == 1)
+    {
+        for (int i = 0; i < numTasks; ++i)
+            task (context, i);
+        return;
+    }
+
+    jassert (numTasks <= 0xffff);
+
+    currentTask.store (task, std::memory_order_relaxed);
+    currentContext.store (context, std::memory_order_relaxed);
+    tasksRemaining.store (numTasks, std::memory_order_relaxed);
+
+    ++generation;
+    claimState.store ((static_cast<uint64_t> (generation) << 32)
+                        | (static_cast<uint64_t> (numTasks) << 16));
+
+    // Lock-free; a system call only for a worker that is parked.
+    for (auto& w : workers)
+        w->wakeUp.notify();
+
+    // The fallback: whatever no worker has claimed yet runs here.
+    runTasks (generation);
+
+    // Every task is claimed now, so only tasks already running on workers
+    // remain – at most one each.  Spin rather than yield: no system call.
+    while (tasksRemaining.load (std::memory_order_acquire) > 0)
+        cpuRelax();
+}
+
+void ChannelWorkerPool::runTasks (uint32_t dispatchGeneration) noexcept
+{
+    for (;;)
+    {
+        auto claim = claimState.load (std::memory_order_acquire);
+
+        if (generationOf (claim) != dispatchGeneration || indexOf (claim) >= numTasksOf (claim))
+            return;
+
+        if (! claimState.compare_exchange_weak (claim, claim + 1, std::memory_order_acq_rel))
+            continue;
+
+        // A successful claim pins this dispatch: the next one cannot be
+        // published until our task has been counted off below.
+        const auto task    = currentTask.load (std::memory_order_relaxed);
+        const auto context = currentContext.load (std::memory_order_relaxed);
+        task (context, indexOf (claim));
+
+        tasksRemaining.fetch_sub (1, std::memory_order_release);
+    }
+}
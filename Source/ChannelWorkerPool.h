@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+    Hisstory – ChannelWorkerPool.h
+
+    Small fixed-size worker pool that lets the audio thread hand per-channel
+    STFT work to other threads.
+      • Threads are started and stopped off the audio thread (prepareToPlay /
+        releaseResources); dispatching never allocates and never locks.
+      • Parked workers are woken through WorkerWakeup (a futex or its
+        platform equivalent, no mutex); after a dispatch a worker spins for
+        at most spinMicroseconds, to catch the inverse phase of the same
+        hop, before parking again, so an idle pool costs no CPU.
+      • The dispatching thread claims tasks itself, so a dispatch completes
+        even if no worker wakes in time – workers only ever speed it up.
+        Once every task is claimed, the caller only waits for tasks already
+        running on a worker: at most one per worker, with no system call.
+      • Task claiming is a single lock-free CAS on a (generation, task
+        count, next index) word, so a worker that is late for one dispatch
+        can never run a task belonging to the next.
+    The pool only pays off with idle cores; Benchmark --channels measures
+    the speed-up (or cost) on the machine at hand.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+class ChannelWorkerPool
+{
+public:
+    using Task = void (*) (void* context, int taskIndex);
+
+    ChannelWorkerPool();
+    ~ChannelWorkerPool();
+
+    /** Starts `numThreads` workers, replacing any running ones.  Zero leaves
+        the pool empty, in which case run() simply loops on the caller.
+        Not real-time safe. */
+    void start (int numThreads);
+
+    /** Stops and joins all workers.  Not real-time safe. */
+    void stop();
+
+    int getNumThreads() const noexcept { return static_cast<int> (workers.size()); }
+
+    /** Calls task (context, i) for every i in [0, numTasks) and returns once
+        all of them have finished (numTasks ≤ 65535).  The caller works
+        through the tasks too.
+        Waking a parked worker costs one futex-style wake system call, which
+        cannot block; nothing here takes a lock. */
+    void run (Task task, void* context, int numTasks) noexcept;
+
+private:
+    class Worker;
+
+    /** Claims and runs tasks of the given dispatch until none are left. */
+    void runTasks (uint32_t dispatchGeneration) noexcept;
+
+    static uint32_t generationOf (uint64_t claim) noexcept { return static_cast<uint32_t> (claim >> 32); }
+    static int      numTasksOf   (uint64_t claim) noexcept { return static_cast<int> ((claim >> 16) & 0xffffu); }
+    static int      indexOf      (uint64_t claim) noexcept { return static_cast<int> (claim & 0xffffu); }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::atomic<Task>  currentTask    { nullptr };
+    std::atomic<void*> currentContext { nullptr };
+
+    std::atomic<uint64_t> claimState     { 0 };   // generation << 32 | numTasks << 16 | next index
+    std::atomic<int>      tasksRemaining { 0 };
+    uint32_t              generation = 0;         // owned by the dispatching thread
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelWorkerPool)
+};
@@ -0,0 +1,653 @@
+/*
+  ==============================================================================
+    Hisstory – FftBackend.cpp
+  ==============================================================================
+*/
+
+#include "FftBackend.h"
+#include "SpectralKernels.h"
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    using Kind = FftBackend::Kind;
+
+    //==========================================================================
+    //  juce::dsp::FFT
+    //  JUCE's engines all divide the inverse by the size.
+    //==========================================================================
+    class JuceFft final : public FftBackend
+    {
+    public:
+        explicit JuceFft (int order) : FftBackend (order), fft (order) {}
+
+        Kind  getKind() const noexcept override          { return Kind::juce; }
+        float getRoundTripGain() const noexcept override { return 1.0f; }
+
+        void forwardReal (float* data) noexcept override { fft.performRealOnlyForwardTransform (data, true); }
+        void inverseReal (float* data) noexcept override { fft.performRealOnlyInverseTransform (data); }
+
+        void performComplex (const std::complex<float>* input, std::complex<float>* output,
+                             bool inverse) noexcept override
+        {
+            fft.perform (input, output, inverse);
+        }
+
+    private:
+        juce::dsp::FFT fft;
+    };
+
+    //==========================================================================
+    //  Built-in SIMD FFT
+    //  Complex transforms run as radix-2 Stockham passes on split re / im
+    //  arrays, ping-ponging between two buffer pairs, so the output comes out
+    //  in natural order with no bit-reversal pass.  Pass t (stride s = 2^t,
+    //  sub-length n = L / s, m = n / 2) maps, for p < m and q < s,
+    //      y[q + s·2p]     = x[q + s·p] + x[q + s·(p + m)]
+    //      y[q + s·(2p+1)] = (x[q + s·p] − x[q + s·(p + m)]) · W_L^(p·s)
+    //  Strides of 4 and up vectorise over q with one twiddle per p; the
+    //  first two passes vectorise over p and interleave their stores.
+    //
+    //  A real transform of N points packs z[n] = x[2n] + i·x[2n+1] into a
+    //  complex FFT of M = N / 2 points and separates the halves with one
+    //  pass over the bins:
+    //      X[k] = (Z[k] + conj Z[M−k]) / 2 + W_N^k · (Z[k] − conj Z[M−k]) / 2i
+    //  The inverse runs the same steps backwards.  Nothing is normalised, so
+    //  a round trip multiplies by N.
+    //==========================================================================
+    class SimdFft final : public FftBackend
+    {
+    public:
+        explicit SimdFft (int order)
+            : FftBackend (order)
+        {
+            const int n = getSize();
+            halfPlan.build (n / 2);
+            fullPlan.build (n);
+
+            for (int b = 0; b < 2; ++b)
+            {
+                workRe[b].resize (static_cast<size_t> (n));
+                workIm[b].resize (static_cast<size_t> (n));
+            }
+
+            realTwiddleRe.resize (static_cast<size_t> (n / 2));
+            realTwiddleIm.resize (static_cast<size_t> (n / 2));
+
+            for (int k = 0; k < n / 2; ++k)
+            {
+                const double angle = 2.0 * juce::MathConstants<double>::pi * k / n;
+                realTwiddleRe[static_cast<size_t> (k)] = static_cast<float> (std::cos (angle));
+                realTwiddleIm[static_cast<size_t> (k)] = static_cast<float> (-std::sin (angle));
+            }
+        }
+
+        Kind  getKind() const noexcept override          { return Kind::simd; }
+        float getRoundTripGain() const noexcept override { return static_cast<float> (getSize()); }
+
+        void forwardReal (float* data) noexcept override
+        {
+            using namespace HisstoryKernels;
+            const int m = getSize() / 2;
+
+            float* zr = workRe[0].data();
+            float* zi = workIm[0].data();
+
+            forEachSpan (0, m, [&] (auto ops, int n0, int n1)
+            {
+                using O = decltype (ops);
+                for (int n = n0; n < n1; n += O::width)
+                {
+                    typename O::V re, im;
+                    O::loadDeinterleaved (data + 2 * n, re, im);
+                    O::store (zr + n, re);
+                    O::store (zi + n, im);
+                }
+            });
+
+            const int r = runComplex<false> (halfPlan);
+            zr = workRe[r].data();
+            zi = workIm[r].data();
+
+            // ── Separate the even / odd halves ───────────────────────────────
+            //  Bins k and M − k pair up; the reversed load reads M − k
+            //  downwards alongside k.  Z[M] wraps to Z[0], so DC and Nyquist
+            //  are done on their own.
+            const float* wr = realTwiddleRe.data();
+            const float* wi = realTwiddleIm.data();
+
+            forEachSpan (1, m, [&] (auto ops, int k0, int k1)
+            {
+                using O = decltype (ops);
+                const auto half = O::splat (0.5f);
+
+                for (int k = k0; k < k1; k += O::width)
+                {
+                    const int mirror = m - k - (O::width - 1);
+                    const auto ar = O::load (zr + k);
+                    const auto ai = O::load (zi + k);
+                    const auto br = O::reverse (O::load (zr + mirror));
+                    const auto bi = O::reverse (O::load (zi + mirror));
+
+                    const auto evenRe = O::mul (half, O::add (ar, br));
+                    const auto evenIm = O::mul (half, O::sub (ai, bi));
+                    const auto oddRe  = O::mul (half, O::add (ai, bi));
+                    const auto oddIm  = O::mul (half, O::sub (br, ar));
+
+                    const auto twr = O::load (wr + k);
+                    const auto twi = O::load (wi + k);
+
+                    O::storeInterleaved (data + 2 * k,
+                                         O::add (evenRe, O::sub (O::mul (twr, oddRe), O::mul (twi, oddIm))),
+                                         O::add (evenIm, O::add (O::mul (twr, oddIm), O::mul (twi, oddRe))));
+                }
+            });
+
+            const float dc = zr[0], packedNyquist = zi[0];
+            data[0]         = dc + packedNyquist;
+            data[1]         = 0.0f;
+            data[2 * m]     = dc - packedNyquist;
+            data[2 * m + 1] = 0.0f;
+        }
+
+        void inverseReal (float* data) noexcept override
+        {
+            using namespace HisstoryKernels;
+            const int m = getSize() / 2;
+
+            // ── Recombine into the packed half-length spectrum ───────────────
+            //  Z[k] = (X[k] + conj X[M−k]) + i·(X[k] − conj X[M−k])·conj W_N^k
+            float* zr = workRe[0].data();
+            float* zi = workIm[0].data();
+            const float* wr = realTwiddleRe.data();
+            const float* wi = realTwiddleIm.data();
+
+            forEachSpan (0, m, [&] (auto ops, int k0, int k1)
+            {
+                using O = decltype (ops);
+
+                for (int k = k0; k < k1; k += O::width)
+                {
+                    typename O::V ar, ai, br, bi;
+                    O::loadDeinterleaved (data + 2 * k, ar, ai);
+                    O::loadDeinterleaved (data + 2 * (m - k - (O::width - 1)), br, bi);
+                    br = O::reverse (br);
+                    bi = O::reverse (bi);
+
+                    const auto evenRe = O::add (ar, br);
+                    const auto evenIm = O::sub (ai, bi);
+                    const auto diffRe = O::sub (ar, br);
+                    const auto diffIm = O::add (ai, bi);
+
+                    const auto twr = O::load (wr + k);
+                    const auto twi = O::load (wi + k);
+                    const auto oddRe = O::add (O::mul (diffRe, twr), O::mul (diffIm, twi));
+                    const auto oddIm = O::sub (O::mul (diffIm, twr), O::mul (diffRe, twi));
+
+                    O::store (zr + k, O::sub (evenRe, oddIm));
+                    O::store (zi + k, O::add (evenIm, oddRe));
+                }
+            });
+
+            const int r = runComplex<true> (halfPlan);
+            interleave (workRe[r].data(), workIm[r].data(), data, m);
+        }
+
+        void performComplex (const std::complex<float>* input, std::complex<float>* output,
+                             bool inverse) noexcept override
+        {
+            using namespace HisstoryKernels;
+            const int n = getSize();
+            const auto* in = reinterpret_cast<const float*> (input);
+            float* re = workRe[0].data();
+            float* im = workIm[0].data();
+
+            forEachSpan (0, n, [&] (auto ops, int i0, int i1)
+            {
+                using O = decltype (ops);
+                for (int i = i0; i < i1; i += O::width)
+                {
+                    typename O::V r, j;
+                    O::loadDeinterleaved (in + 2 * i, r, j);
+                    O::store (re + i, r);
+                    O::store (im + i, j);
+                }
+            });
+
+            const int r = inverse ? runComplex<true> (fullPlan) : runComplex<false> (fullPlan);
+            interleave (workRe[r].data(), workIm[r].data(), reinterpret_cast<float*> (output), n);
+        }
+
+    private:
+        //======================================================================
+        /** Twiddles for one complex length L: W_L^k for k < L / 2, plus the
+            stride-2 pass's W_L^(2p) with each value repeated for q = 0, 1. */
+        struct Plan
+        {
+            int length = 0;
+            std::vector<float> twRe, twIm;
+            std::vector<float> pairRe, pairIm;
+
+            void build (int l)
+            {
+                length = l;
+                twRe.resize (static_cast<size_t> (l / 2));
+                twIm.resize (static_cast<size_t> (l / 2));
+
+                for (int k = 0; k < l / 2; ++k)
+                {
+                    const double angle = 2.0 * juce::MathConstants<double>::pi * k / l;
+                    twRe[static_cast<size_t> (k)] = static_cast<float> (std::cos (angle));
+                    twIm[static_cast<size_t> (k)] = static_cast<float> (-std::sin (angle));
+                }
+
+                pairRe.resize (static_cast<size_t> (l / 2));
+                pairIm.resize (static_cast<size_t> (l / 2));
+
+                for (int i = 0; i < l / 2; ++i)
+                {
+                    const auto k = static_cast<size_t> ((i / 2) * 2);
+                    pairRe[static_cast<size_t> (i)] = twRe[k];
+                    pairIm[static_cast<size_t> (i)] = twIm[k];
+                }
+            }
+        };
+
+        Plan halfPlan, fullPlan;
+        std::array<std::vector<float>, 2> workRe, workIm;
+        std::vector<float> realTwiddleRe, realTwiddleIm;
+
+        //======================================================================
+        /** (a − b) · w, or · conj w for the inverse. */
+        template <bool Inverse, typename O>
+        static void rotate (typename O::V dr, typename O::V di, typename O::V wr, typename O::V wi,
+                            typename O::V& outRe, typename O::V& outIm) noexcept
+        {
+            if constexpr (Inverse)
+            {
+                outRe = O::add (O::mul (dr, wr), O::mul (di, wi));
+                outIm = O::sub (O::mul (di, wr), O::mul (dr, wi));
+            }
+            else
+            {
+                outRe = O::sub (O::mul (dr, wr), O::mul (di, wi));
+                outIm = O::add (O::mul (di, wr), O::mul (dr, wi));
+            }
+        }
+
+        /** Runs every pass over the plan's length, starting from work buffer
+            0; returns the index of the buffer holding the result. */
+        template <bool Inverse>
+        int runComplex (const Plan& plan) noexcept
+        {
+            using namespace HisstoryKernels;
+            const int l = plan.length;
+            int src = 0;
+
+            for (int s = 1; s < l; s *= 2)
+            {
+                const int m = l / (2 * s);
+                const float* xr = workRe[src].data();
+                const float* xi = workIm[src].data();
+                float* yr = workRe[1 - src].data();
+                float* yi = workIm[1 - src].data();
+
+                if constexpr (SimdOps::width == 4)
+                {
+                    if (s == 1)       { passStrideOne<Inverse>  (plan, xr, xi, yr, yi, m); src = 1 - src; continue; }
+                    if (s == 2)       { passStrideTwo<Inverse>  (plan, xr, xi, yr, yi, m); src = 1 - src; continue; }
+                }
+
+                passWide<Inverse> (plan, xr, xi, yr, yi, m, s);
+                src = 1 - src;
+            }
+
+            return src;
+        }
+
+        /** s = 1: four values of p per vector, results interleaved. */
+        template <bool Inverse>
+        static void passStrideOne (const Plan& plan, const float* xr, const float* xi,
+                                   float* yr, float* yi, int m) noexcept
+        {
+            using O = HisstoryKernels::SimdOps;
+
+            for (int p = 0; p < m; p += O::width)
+            {
+                const auto ar = O::load (xr + p),     ai = O::load (xi + p);
+                const auto br = O::load (xr + p + m), bi = O::load (xi + p + m);
+
+                typename O::V vr, vi;
+                rotate<Inverse, O> (O::sub (ar, br), O::sub (ai, bi),
+                                    O::load (plan.twRe.data() + p), O::load (plan.twIm.data() + p), vr, vi);
+
+                O::storeInterleaved (yr + 2 * p, O::add (ar, br), vr);
+                O::storeInterleaved (yi + 2 * p, O::add (ai, bi), vi);
+            }
+        }
+
+        /** s = 2: lanes are (p, q) = (p, 0) (p, 1) (p+1, 0) (p+1, 1). */
+        template <bool Inverse>
+        static void passStrideTwo (const Plan& plan, const float* xr, const float* xi,
+                                   float* yr, float* yi, int m) noexcept
+        {
+            using O = HisstoryKernels::SimdOps;
+
+            for (int p = 0; p < m; p += 2)
+            {
+                const int i = 2 * p;
+                const auto ar = O::load (xr + i),         ai = O::load (xi + i);
+                const auto br = O::load (xr + i + 2 * m), bi = O::load (xi + i + 2 * m);
+
+                typename O::V vr, vi;
+                rotate<Inverse, O> (O::sub (ar, br), O::sub (ai, bi),
+                                    O::load (plan.pairRe.data() + i), O::load (plan.pairIm.data() + i), vr, vi);
+
+                O::storeInterleavedPairs (yr + 4 * p, O::add (ar, br), vr);
+                O::storeInterleavedPairs (yi + 4 * p, O::add (ai, bi), vi);
+            }
+        }
+
+        /** Any stride; vectorised over q once s is a multiple of the width. */
+        template <bool Inverse>
+        static void passWide (const Plan& plan, const float* xr, const float* xi,
+                              float* yr, float* yi, int m, int s) noexcept
+        {
+            using namespace HisstoryKernels;
+
+            for (int p = 0; p < m; ++p)
+            {
+                const float wr = plan.twRe[static_cast<size_t> (p * s)];
+                const float wi = plan.twIm[static_cast<size_t> (p * s)];
+                const int   a  = s * p;
+                const int   b  = s * (p + m);
+                const int   u  = s * 2 * p;
+                const int   v  = s * (2 * p + 1);
+
+                forEachSpan (0, s, [&] (auto ops, int q0, int q1)
+                {
+                    using O = decltype (ops);
+                    const auto twr = O::splat (wr), twi = O::splat (wi);
+
+                    for (int q = q0; q < q1; q += O::width)
+                    {
+                        const auto ar = O::load (xr + a + q), ai = O::load (xi + a + q);
+                        const auto br = O::load (xr + b + q), bi = O::load (xi + b + q);
+
+                        typename O::V vr, vi;
+                        rotate<Inverse, O> (O::sub (ar, br), O::sub (ai, bi), twr, twi, vr, vi);
+
+                        O::store (yr + u + q, O::add (ar, br));
+                        O::store (yi + u + q, O::add (ai, bi));
+                        O::store (yr + v + q, vr);
+                        O::store (yi + v + q, vi);
+                    }
+                });
+            }
+        }
+
+        static void interleave (const float* re, const float* im, float* dest, int n) noexcept
+        {
+            HisstoryKernels::forEachSpan (0, n, [&] (auto ops, int i0, int i1)
+            {
+                using O = decltype (ops);
+                for (int i = i0; i < i1; i += O::width)
+                    O::storeInterleaved (dest + 2 * i, O::load (re + i), O::load (im + i));
+            });
+        }
+    };
+
+    //==========================================================================
+    //  Reference: textbook radix-2 in double precision, unnormalised
+    //==========================================================================
+    class ReferenceFft final : public FftBackend
+    {
+    public:
+        explicit ReferenceFft (int order)
+            : FftBackend (order),
+              work (static_cast<size_t> (getSize())),
+              twiddles (static_cast<size_t> (getSize() / 2))
+        {
+            const int n = getSize();
+            for (int k = 0; k < n / 2; ++k)
+                twiddles[static_cast<size_t> (k)] = std::polar (1.0, -2.0 * juce::MathConstants<double>::pi * k / n);
+        }
+
+        Kind  getKind() const noexcept override          { return Kind::reference; }
+        float getRoundTripGain() const noexcept override { return static_cast<float> (getSize()); }
+
+        void forwardReal (float* data) noexcept override
+        {
+            const int n = getSize();
+            for (int i = 0; i < n; ++i)
+                work[static_cast<size_t> (i)] = data[i];
+
+            transform (false);
+
+            for (int k = 0; k <= n / 2; ++k)
+            {
+                data[2 * k]     = static_cast<float> (work[static_cast<size_t> (k)].real());
+                data[2 * k + 1] = static_cast<float> (work[static_cast<size_t> (k)].imag());
+            }
+        }
+
+        void inverseReal (float* data) noexcept override
+        {
+            const int n = getSize();
+            for (int k = 0; k <= n / 2; ++k)
+                work[static_cast<size_t> (k)] = { data[2 * k], data[2 * k + 1] };
+
+            for (int k = n / 2 + 1; k < n; ++k)
+                work[static_cast<size_t> (k)] = std::conj (work[static_cast<size_t> (n - k)]);
+
+            transform (true);
+
+            for (int i = 0; i < n; ++i)
+                data[i] = static_cast<float> (work[static_cast<size_t> (i)].real());
+        }
+
+        void performComplex (const std::complex<float>* input, std::complex<float>* output,
+                             bool inverse) noexcept override
+        {
+            const int n = getSize();
+            for (int i = 0; i < n; ++i)
+                work[static_cast<size_t> (i)] = input[i];
+
+            transform (inverse);
+
+            for (int i = 0; i < n; ++i)
+                output[i] = std::complex<float> (work[static_cast<size_t> (i)]);
+        }
+
+    private:
+        std::vector<std::complex<double>> work, twiddles;
+
+        void transform (bool inverse) noexcept
+        {
+            const int n = getSize();
+
+            for (int i = 1, j = 0; i < n; ++i)
+            {
+                int bit = n >> 1;
+                for (; (j & bit) != 0; bit >>= 1)
+                    j ^= bit;
+                j ^= bit;
+
+                if (i < j)
+                    std::swap (work[static_cast<size_t> (i)], work[static_cast<size_t> (j)]);
+            }
+
+            for (int len = 2; len <= n; len *= 2)
+            {
+                const int step = n / len;
+
+                for (int start = 0; start < n; start += len)
+                {
+                    for (int j = 0; j < len / 2; ++j)
+                    {
+                        auto w = twiddles[static_cast<size_t> (j * step)];
+                        if (inverse)
+                            w = std::conj (w);
+
+                        auto& a = work[static_cast<size_t> (start + j)];
+                        auto& b = work[static_cast<size_t> (start + j + len / 2)];
+                        const auto t = b * w;
+                        b = a - t;
+                        a = a + t;
+                    }
+                }
+            }
+        }
+    };
+
+    //==========================================================================
+    //  Automatic selection
+    //==========================================================================
+    /** Checks a backend against the reference: forward bins, and both round
+        trips against the declared gain. */
+    bool matchesReference (FftBackend& fft)
+    {
+        const int n = fft.getSize();
+        ReferenceFft reference (fft.getOrder());
+
+        std::vector<float> signal (static_cast<size_t> (n));
+        for (int i = 0; i < n; ++i)
+            signal[static_cast<size_t> (i)] = std::sin (0.37f * i) + 0.5f * std::cos (2.9f * i + 0.3f);
+
+        std::vector<float> data (static_cast<size_t> (2 * n)), expected (static_cast<size_t> (2 * n));
+        std::copy (signal.begin(), signal.end(), data.begin());
+        std::copy (signal.begin(), signal.end(), expected.begin());
+        fft.forwardReal (data.data());
+        reference.forwardReal (expected.data());
+
+        float peak = 0.0f, binError = 0.0f;
+        for (int i = 0; i < n + 2; ++i)
+        {
+            peak     = std::max (peak, std::abs (expected[static_cast<size_t> (i)]));
+            binError = std::max (binError, std::abs (data[static_cast<size_t> (i)] - expected[static_cast<size_t> (i)]));
+        }
+
+        fft.inverseReal (data.data());
+
+        const float gain = fft.getRoundTripGain();
+        float realError = 0.0f;
+        for (int i = 0; i < n; ++i)
+            realError = std::max (realError, std::abs (data[static_cast<size_t> (i)] / gain - signal[static_cast<size_t> (i)]));
+
+        std::vector<std::complex<float>> complexSignal (static_cast<size_t> (n)), spectrum (static_cast<size_t> (n)),
+                                         roundTrip (static_cast<size_t> (n));
+        for (int i = 0; i < n; ++i)
+            complexSignal[static_cast<size_t> (i)] = { signal[static_cast<size_t> (i)], signal[static_cast<size_t> (n - 1 - i)] };
+
+        fft.performComplex (complexSignal.data(), spectrum.data(), false);
+        fft.performComplex (spectrum.data(), roundTrip.data(), true);
+
+        float complexError = 0.0f;
+        for (int i = 0; i < n; ++i)
+            complexError = std::max (complexError, std::abs (roundTrip[static_cast<size_t> (i)] / gain
+                                                             - complexSignal[static_cast<size_t> (i)]));
+
+        return binError <= 1.0e-4f * peak && realError <= 1.0e-4f && complexError <= 1.0e-4f;
+    }
+
+    /** Seconds for one hop's worth of work – a real round trip and a complex
+        round trip – best of a few batches. */
+    double timeTransforms (FftBackend& fft)
+    {
+        const int n = fft.getSize();
+        const int repeats = std::max (4, (1 << 17) >> fft.getOrder());
+
+        std::vector<float> source (static_cast<size_t> (2 * n)), data (static_cast<size_t> (2 * n));
+        std::vector<std::complex<float>> complexData (static_cast<size_t> (n)), spectrum (static_cast<size_t> (n));
+        for (int i = 0; i < n; ++i)
+            source[static_cast<size_t> (i)] = std::sin (0.01f * i);
+
+        double best = std::numeric_limits<double>::max();
+
+        for (int batch = 0; batch < 4; ++batch)    // the first batch warms caches
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+
+            for (int r = 0; r < repeats; ++r)
+            {
+                std::copy (source.begin(), source.begin() + n, data.begin());
+                fft.forwardReal (data.data());
+                fft.inverseReal (data.data());
+
+                for (int i = 0; i < n; ++i)
+                    complexData[static_cast<size_t> (i)] = { source[static_cast<size_t> (i)], 0.0f };
+
+                fft.performComplex (complexData.data(), spectrum.data(), false);
+                fft.performComplex (spectrum.data(), complexData.data(), true);
+            }
+
+            const double seconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - start);
+
+            if (batch > 0)
+                best = std::min (best, seconds / repeats);
+        }
+
+        return best;
+    }
+}
+
+//==============================================================================
+std::unique_ptr<FftBackend> FftBackend::create (int order, Kind kind)
+{
+    switch (kind == Kind::automatic ? selectFastest (order) : kind)
+    {
+        case Kind::simd:       return std::make_unique<SimdFft> (order);
+        case Kind::reference:  return std::make_unique<ReferenceFft> (order);
+        case Kind::juce:
+        case Kind::automatic:
+        default:               return std::make_unique<JuceFft> (order);
+    }
+}
+
+FftBackend::Kind FftBackend::selectFastest (int order)
+{
+    static juce::CriticalSection lock;
+    static std::array<Kind, 32> chosen {};      // automatic = not measured yet
+
+    const juce::ScopedLock sl (lock);
+    auto& choice = chosen[static_cast<size_t> (order)];
+
+    if (choice != Kind::automatic)
+        return choice;
+
+    choice = Kind::juce;
+    double fastest = std::numeric_limits<double>::max();
+
+    for (const auto candidate : { Kind::juce, Kind::simd })
+    {
+        auto fft = create (order, candidate);
+
+        if (! matchesReference (*fft))
+            continue;
+
+        const double seconds = timeTransforms (*fft);
+
+        if (seconds < fastest)
+        {
+            fastest = seconds;
+            choice  = candidate;
+        }
+    }
+
+    return choice;
+}
+
+const char* FftBackend::getName (Kind kind) noexcept
+{
+    switch (kind)
+    {
+        case Kind::juce:       return "juce";
+        case Kind::simd:       return "simd";
+        case Kind::reference:  return "reference";
+        case Kind::automatic:
+        default:               return "automatic";
+    }
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+    Hisstory – FftBackend.h
+
+    The engine's FFTs behind one interface, with interchangeable built-in
+    implementations:
+      • juce      – juce::dsp::FFT, i.e. whatever the platform build provides
+                    (vDSP, IPP, FFTW or JUCE's own scalar fallback)
+      • simd      – a split-format Stockham FFT on the SpectralKernels ops
+                    policies (SSE2 / NEON); real transforms run as a
+                    half-length complex FFT plus one twiddle pass
+      • reference – plain radix-2 in double precision, the ground truth for
+                    tests; never picked automatically
+    Every backend takes unnormalised forward transforms and declares how its
+    inverse scales, so the engine needs no impulse probe.  With `automatic`
+    the first create() for an FFT order times the candidates on this CPU,
+    after checking each one's round trip against its declared gain, and the
+    fastest is used for that order by every instance in the process.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <complex>
+#include <memory>
+
+//==============================================================================
+class FftBackend
+{
+public:
+    enum class Kind
+    {
+        automatic,      // fastest measured on this CPU (resolved by create)
+        juce,
+        simd,
+        reference
+    };
+
+    virtual ~FftBackend() = default;
+
+    /** Creates a backend for 2^order points.  `automatic` resolves through
+        selectFastest().  Not real-time safe. */
+    static std::unique_ptr<FftBackend> create (int order, Kind kind = Kind::automatic);
+
+    /** The backend `automatic` uses for this order: benchmarked on the first
+        call, then cached for the process.  Not real-time safe. */
+    static Kind selectFastest (int order);
+
+    static const char* getName (Kind kind) noexcept;
+
+    virtual Kind getKind() const noexcept = 0;
+    int  getOrder() const noexcept { return order; }
+    int  getSize()  const noexcept { return 1 << order; }
+
+    /** Forward real transform in place.  data holds 2 · getSize() floats:
+        the first getSize() are the input, and on return the first
+        getSize() / 2 + 1 complex bins are stored interleaved (re, im) from
+        data[0]; anything after them is undefined.  Unnormalised. */
+    virtual void forwardReal (float* data) noexcept = 0;
+
+    /** Inverse of forwardReal(), in place: reads the getSize() / 2 + 1 bins
+        and leaves getSize() samples, scaled by getRoundTripGain(). */
+    virtual void inverseReal (float* data) noexcept = 0;
+
+    /** Out-of-place complex transform of getSize() points.  The forward
+        direction is unnormalised; the inverse scales like inverseReal(). */
+    virtual void performComplex (const std::complex<float>* input, std::complex<float>* output,
+                                 bool inverse) noexcept = 0;
+
+    /** What a forward transform followed by an inverse multiplies by: 1 if
+        the inverse divides by the size, otherwise getSize(). */
+    virtual float getRoundTripGain() const noexcept = 0;
+
+protected:
+    explicit FftBackend (int fftOrder) : order (fftOrder) {}
+
+private:
+    const int order;
+
+    JUCE_DECLARE_NON_COPYABLE (FftBackend)
+};
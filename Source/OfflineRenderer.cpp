@@ -0,0 +1,536 @@
+/*
+  ==============================================================================
+    Hisstory – OfflineRenderer.cpp
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+#include "PluginProcessor.h"
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer (const Settings& s)
+    : settings (s)
+{
+}
+
+//==============================================================================
+//  Processor set-up: saved state, then individual parameters and options
+//==============================================================================
+juce::Result OfflineRenderer::configure (HisstoryAudioProcessor& proc) const
+{
+    if (settings.stateFile != juce::File())
+    {
+        auto xml = juce::parseXML (settings.stateFile);
+
+        if (xml == nullptr)
+            return juce::Result::fail ("Cannot parse state file " + settings.stateFile.getFullPathName());
+
+        if (! xml->hasTagName (proc.apvts.state.getType()))
+            return juce::Result::fail (settings.stateFile.getFullPathName() + " is not a Hisstory state");
+
+        juce::MemoryBlock data;
+        juce::AudioProcessor::copyXmlToBinary (*xml, data);
+        proc.setStateInformation (data.getData(), static_cast<int> (data.getSize()));
+    }
+
+    for (const auto& id : settings.parameters.getAllKeys())
+    {
+        auto* param = proc.apvts.getParameter (id);
+
+        if (param == nullptr)
+            return juce::Result::fail ("Unknown parameter '" + id + "'");
+
+        const auto text = settings.parameters[id].trim();
+        float value;
+
+        if (text.equalsIgnoreCase ("on") || text.equalsIgnoreCase ("true"))
+            value = 1.0f;
+        else if (text.equalsIgnoreCase ("off") || text.equalsIgnoreCase ("false"))
+            value = 0.0f;
+        else if (text.containsOnly ("+-.0123456789eE") && text.isNotEmpty())
+            value = text.getFloatValue();
+        else
+            return juce::Result::fail ("Bad value '" + text + "' for parameter '" + id + "'");
+
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    if (settings.fftOrder != 0)
+    {
+        if (settings.fftOrder < HisstoryAudioProcessor::minFftOrder
+             || settings.fftOrder > HisstoryAudioProcessor::maxFftOrder)
+            return juce::Result::fail ("FFT order must be "
+                                       + juce::String (HisstoryAudioProcessor::minFftOrder) + " to "
+                                       + juce::String (HisstoryAudioProcessor::maxFftOrder));
+
+        proc.setFftOrder (settings.fftOrder);
+    }
+
+    if (settings.lowLatency >= 0)
+        proc.setLowLatencyMode (settings.lowLatency != 0);
+
+    proc.setFftBackend (settings.fftBackend);
+    return juce::Result::ok();
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::writeState (const juce::File& destination) const
+{
+    HisstoryAudioProcessor proc;
+
+    if (auto result = configure (proc); result.failed())
+        return result;
+
+    juce::MemoryBlock data;
+    proc.getStateInformation (data);
+    auto xml = juce::AudioProcessor::getXmlFromBinary (data.getData(), static_cast<int> (data.getSize()));
+
+    if (xml == nullptr || ! xml->writeTo (destination))
+        return juce::Result::fail ("Cannot write " + destination.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::createProcessor (std::unique_ptr<HisstoryAudioProcessor>& proc,
+                                               int numChannels, double sampleRate) const
+{
+    proc = std::make_unique<HisstoryAudioProcessor>();
+
+    if (auto result = configure (*proc); result.failed())
+        return result;
+
+    proc->setOfflineStftThreads (settings.stftThreads);
+    proc->setPlayConfigDetails (numChannels, numChannels, sampleRate, settings.blockSize);
+    proc->prepareToPlay (sampleRate, settings.blockSize);
+    return juce::Result::ok();
+}
+
+//==============================================================================
+//  Streaming
+//  Every block is full-size; past the end of the input the reader supplies
+//  silence, which pushes the last `latency` samples out of the processor.
+//  Sample i of a block read from input position p is the processed input
+//  sample p + i − latency.
+//==============================================================================
+juce::Result OfflineRenderer::stream (juce::AudioFormatReader& reader, HisstoryAudioProcessor& proc,
+                                      juce::int64 inputStart, juce::int64 outputStart, juce::int64 outputEnd,
+                                      const Sink& sink, juce::int64& processTicks) const
+{
+    const int n       = settings.blockSize;
+    const int latency = proc.getLatencySamples();
+
+    juce::AudioBuffer<float> block (static_cast<int> (reader.numChannels), n);
+    juce::MidiBuffer midi;
+
+    for (auto readPos = inputStart, next = outputStart; next < outputEnd; readPos += n)
+    {
+        if (! reader.read (&block, 0, n, readPos, true, true))
+            return juce::Result::fail ("Read failed at input sample " + juce::String (readPos));
+
+        const auto blockTicks = juce::Time::getHighResolutionTicks();
+        proc.processBlock (block, midi);
+        processTicks += juce::Time::getHighResolutionTicks() - blockTicks;
+
+        const auto firstOutput = readPos - latency;
+        const int  skip  = static_cast<int> (juce::jlimit<juce::int64> (0, n, next - firstOutput));
+        const int  count = static_cast<int> (juce::jmin<juce::int64> (n - skip, outputEnd - next));
+
+        if (count > 0)
+        {
+            if (! sink (block, skip, count))
+                return juce::Result::fail ("Write failed at output sample " + juce::String (next));
+
+            next += count;
+        }
+    }
+
+    return juce::Result::ok();
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::render (const juce::File& input, const juce::File& output, Stats& stats) const
+{
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    if (settings.blockSize < 1)
+        return juce::Result::fail ("Block size must be positive");
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+    if (reader == nullptr)
+        return juce::Result::fail ("Cannot read " + input.getFullPathName());
+
+    const int    numChannels = static_cast<int> (reader->numChannels);
+    const double sampleRate  = reader->sampleRate;
+    const auto   length      = reader->lengthInSamples;
+
+    if (numChannels < 1 || numChannels > HisstoryAudioProcessor::maxNumChannels)
+        return juce::Result::fail (input.getFileName() + ": " + juce::String (numChannels)
+                                   + " channels (1 to " + juce::String (HisstoryAudioProcessor::maxNumChannels)
+                                   + " supported)");
+
+    auto* format = formats.findFormatForFileExtension (output.getFileExtension());
+
+    if (format == nullptr)
+        return juce::Result::fail ("No audio format for " + output.getFileName());
+
+    // ── Processor (serial) or settings check (segmented) ─────────────────────
+    const bool segmented = settings.segmentThreads > 1
+                            && length > static_cast<juce::int64> (settings.segmentSeconds * sampleRate);
+
+    if (segmented && (settings.segmentSeconds <= settings.crossfadeSeconds
+                       || settings.preRollSeconds < 0.0 || settings.crossfadeSeconds < 0.0))
+        return juce::Result::fail ("Segments must be longer than the crossfade, and the pre-roll and "
+                                   "crossfade not negative");
+
+    std::unique_ptr<HisstoryAudioProcessor> proc;
+
+    if (! segmented)
+        if (auto result = createProcessor (proc, numChannels, sampleRate); result.failed())
+            return result;
+
+    // ── Writer ───────────────────────────────────────────────────────────────
+    output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> outStream (output.createOutputStream());
+
+    if (outStream == nullptr || outStream->failedToOpen())
+        return juce::Result::fail ("Cannot create " + output.getFullPathName());
+
+    std::unique_ptr<juce::AudioFormatWriter> writer (
+        format->createWriterFor (outStream.get(), sampleRate, static_cast<unsigned int> (numChannels),
+                                 settings.bitsPerSample, {}, 0));
+
+    if (writer == nullptr)
+        return juce::Result::fail (format->getFormatName() + " cannot write " + juce::String (numChannels)
+                                   + " channels at " + juce::String (settings.bitsPerSample) + " bits");
+
+    outStream.release();    // the writer owns it now
+
+    // ── Process ──────────────────────────────────────────────────────────────
+    stats = {};
+    stats.numSamples  = length;
+    stats.numChannels = numChannels;
+    stats.sampleRate  = sampleRate;
+
+    if (segmented)
+    {
+        if (auto result = renderSegments (input, *reader, *writer, stats); result.failed())
+            return result;
+    }
+    else
+    {
+        juce::int64 processTicks = 0;
+        const auto write = [&] (const juce::AudioBuffer<float>& block, int start, int count)
+        {
+            return writer->writeFromAudioSampleBuffer (block, start, count);
+        };
+
+        if (auto result = stream (*reader, *proc, 0, 0, length, write, processTicks); result.failed())
+            return juce::Result::fail (input.getFileName() + " to " + output.getFullPathName() + ": "
+                                       + result.getErrorMessage());
+
+        stats.latencySamples = proc->getLatencySamples();
+        stats.processSeconds = juce::Time::highResolutionTicksToSeconds (processTicks);
+        proc->releaseResources();
+    }
+
+    writer.reset();     // flushes and finalises the header
+
+    stats.totalSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+
+    return juce::Result::ok();
+}
+
+//==============================================================================
+//  Segmented render
+//  Segment k owns output [k·L, (k+1)·L) and also renders the F samples
+//  before it, which are crossfaded with the previous segment's last F; its
+//  processor starts P samples earlier still, so the noise tracker, the
+//  stationarity statistics and the gain smoothing have converged on the
+//  same material a serial render would have seen.  Each segment streams
+//  exactly like a serial render (latency flushed and trimmed), so the
+//  pieces are sample-aligned.  Workers take segments in order; this thread
+//  writes them in order as they complete.
+//==============================================================================
+struct OfflineRenderer::Segment
+{
+    juce::int64 inputStart = 0, outputStart = 0, outputEnd = 0;
+    juce::AudioBuffer<float> audio;
+    juce::Result result = juce::Result::ok();
+    int  latency = 0;
+    bool done = false;
+};
+
+namespace
+{
+    class SegmentWorker : public juce::Thread
+    {
+    public:
+        explicit SegmentWorker (std::function<void()> work)
+            : juce::Thread ("Hisstory segment worker"), body (std::move (work)) {}
+
+        void run() override { body(); }
+
+    private:
+        std::function<void()> body;
+    };
+}
+
+juce::Result OfflineRenderer::renderSegment (const juce::File& input, Segment& segment, juce::int64& processTicks) const
+{
+    // Each worker decodes through its own reader.
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (input));
+
+    if (reader == nullptr)
+        return juce::Result::fail ("Cannot read " + input.getFullPathName());
+
+    const int numChannels = static_cast<int> (reader->numChannels);
+    std::unique_ptr<HisstoryAudioProcessor> proc;
+
+    if (auto result = createProcessor (proc, numChannels, reader->sampleRate); result.failed())
+        return result;
+
+    segment.latency = proc->getLatencySamples();
+    segment.audio.setSize (numChannels, static_cast<int> (segment.outputEnd - segment.outputStart));
+
+    int filled = 0;
+    const auto collect = [&] (const juce::AudioBuffer<float>& block, int start, int count)
+    {
+        if (filled + count > segment.audio.getNumSamples())
+            return false;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            segment.audio.copyFrom (ch, filled, block, ch, start, count);
+
+        filled += count;
+        return true;
+    };
+
+    const auto result = stream (*reader, *proc, segment.inputStart, segment.outputStart, segment.outputEnd,
+                                collect, processTicks);
+    proc->releaseResources();
+
+    if (result.failed())
+        return juce::Result::fail (input.getFileName() + ", segment from sample "
+                                   + juce::String (segment.outputStart) + ": " + result.getErrorMessage());
+
+    return juce::Result::ok();
+}
+
+juce::Result OfflineRenderer::renderSegments (const juce::File& input, juce::AudioFormatReader& reader,
+                                              juce::AudioFormatWriter& writer, Stats& stats) const
+{
+    const double sampleRate = reader.sampleRate;
+    const auto   length     = reader.lengthInSamples;
+    const int    numChannels = static_cast<int> (reader.numChannels);
+
+    const auto segmentLength = static_cast<juce::int64> (settings.segmentSeconds * sampleRate);
+    const auto preRoll       = static_cast<juce::int64> (settings.preRollSeconds * sampleRate);
+    const int  fade          = static_cast<int> (settings.crossfadeSeconds * sampleRate);
+
+    // Starting every processor on a multiple of the largest FFT size puts
+    // its frames on the serial render's hop grid; otherwise each segment
+    // would analyse the signal at a different frame phase.
+    constexpr juce::int64 frameGrid = 1 << HisstoryAudioProcessor::maxFftOrder;
+
+    std::vector<Segment> segments (static_cast<size_t> ((length + segmentLength - 1) / segmentLength));
+
+    for (size_t k = 0; k < segments.size(); ++k)
+    {
+        auto& s = segments[k];
+        const auto boundary = static_cast<juce::int64> (k) * segmentLength;
+
+        s.outputStart = k == 0 ? 0 : boundary - fade;
+        s.outputEnd   = juce::jmin (boundary + segmentLength, length);
+        s.inputStart  = juce::jmax<juce::int64> (0, s.outputStart - preRoll) / frameGrid * frameGrid;
+    }
+
+    // ── Workers ──────────────────────────────────────────────────────────────
+    const int numThreads = juce::jmin (settings.segmentThreads, static_cast<int> (segments.size()));
+    const int maxPending = numThreads + 2;      // segments rendered but not yet written
+
+    std::mutex lock;
+    std::condition_variable changed;
+    int  nextSegment = 0, numWritten = 0;
+    bool abandoned = false;
+    std::atomic<juce::int64> processTicks { 0 };
+
+    const auto work = [&]
+    {
+        for (;;)
+        {
+            int k;
+            {
+                std::unique_lock<std::mutex> sl (lock);
+                changed.wait (sl, [&] { return abandoned || nextSegment >= static_cast<int> (segments.size())
+                                                       || nextSegment < numWritten + maxPending; });
+
+                if (abandoned || nextSegment >= static_cast<int> (segments.size()))
+                    return;
+
+                k = nextSegment++;
+            }
+
+            juce::int64 ticks = 0;
+            auto result = renderSegment (input, segments[static_cast<size_t> (k)], ticks);
+            processTicks += ticks;
+
+            const std::lock_guard<std::mutex> sl (lock);
+            segments[static_cast<size_t> (k)].result = result;
+            segments[static_cast<size_t> (k)].done   = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::unique_ptr<SegmentWorker>> workers;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        workers.push_back (std::make_unique<SegmentWorker> (work));
+        workers.back()->startThread();
+    }
+
+    const auto finish = [&] (juce::Result result)
+    {
+        {
+            const std::lock_guard<std::mutex> sl (lock);
+            abandoned = true;
+            changed.notify_all();
+        }
+
+        for (auto& w : workers)
+            w->waitForThreadToExit (-1);
+
+        return result;
+    };
+
+    // ── Stitch and write, in order ───────────────────────────────────────────
+    //  The last `fade` samples of each segment are held back until the next
+    //  one arrives and fades in over them (equal-gain sin² ramp: the two
+    //  renders are strongly correlated).
+    juce::AudioBuffer<float> tail (numChannels, juce::jmax (1, fade));
+
+    for (size_t k = 0; k < segments.size(); ++k)
+    {
+        auto& s = segments[k];
+        {
+            std::unique_lock<std::mutex> sl (lock);
+            changed.wait (sl, [&] { return s.done; });
+        }
+
+        if (s.result.failed())
+            return finish (s.result);
+
+        const int  size   = s.audio.getNumSamples();
+        const bool isLast = k + 1 == segments.size();
+        const int  end    = isLast ? size : size - fade;
+
+        for (int ch = 0; ch < numChannels && k > 0; ++ch)
+        {
+            auto* dest       = s.audio.getWritePointer (ch);
+            const auto* prev = tail.getReadPointer (ch);
+
+            for (int i = 0; i < fade; ++i)
+            {
+                const auto w = std::sin (juce::MathConstants<float>::halfPi * (static_cast<float> (i) + 0.5f)
+                                         / static_cast<float> (fade));
+                dest[i] = prev[i] + w * w * (dest[i] - prev[i]);
+            }
+        }
+
+        if (! writer.writeFromAudioSampleBuffer (s.audio, 0, end))
+            return finish (juce::Result::fail ("Write failed"));
+
+        if (! isLast)
+            for (int ch = 0; ch < numChannels; ++ch)
+                tail.copyFrom (ch, 0, s.audio, ch, end, fade);
+
+        stats.latencySamples = s.latency;
+        s.audio.setSize (0, 0);
+
+        const std::lock_guard<std::mutex> sl (lock);
+        ++numWritten;
+        changed.notify_all();
+    }
+
+    finish (juce::Result::ok());
+
+    stats.numSegments    = static_cast<int> (segments.size());
+    stats.processSeconds = juce::Time::highResolutionTicksToSeconds (processTicks.load());
+    return juce::Result::ok();
+}
+
+//==============================================================================
+//  Comparison
+//==============================================================================
+juce::Result OfflineRenderer::compare (const juce::File& rendered, const juce::File& reference, Difference& result)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> a (formats.createReaderFor (rendered));
+    std::unique_ptr<juce::AudioFormatReader> b (formats.createReaderFor (reference));
+
+    if (a == nullptr || b == nullptr)
+        return juce::Result::fail ("Cannot read " + (a == nullptr ? rendered : reference).getFullPathName());
+
+    if (a->numChannels != b->numChannels || a->lengthInSamples != b->lengthInSamples)
+        return juce::Result::fail (rendered.getFileName() + " and " + reference.getFileName()
+                                   + " differ in length or channel count");
+
+    constexpr int blockSize = 65536;
+    const int numChannels = static_cast<int> (a->numChannels);
+
+    juce::AudioBuffer<float> blockA (numChannels, blockSize), blockB (numChannels, blockSize);
+    double sumDiff = 0.0, sumRef = 0.0;
+    result = {};
+    result.numSamples = a->lengthInSamples;
+
+    for (juce::int64 pos = 0; pos < result.numSamples; pos += blockSize)
+    {
+        const int n = static_cast<int> (juce::jmin<juce::int64> (blockSize, result.numSamples - pos));
+        a->read (&blockA, 0, n, pos, true, true);
+        b->read (&blockB, 0, n, pos, true, true);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* x = blockA.getReadPointer (ch);
+            const auto* y = blockB.getReadPointer (ch);
+
+            for (int i = 0; i < n; ++i)
+            {
+                const double d = static_cast<double> (x[i]) - static_cast<double> (y[i]);
+                sumDiff += d * d;
+                sumRef  += static_cast<double> (y[i]) * static_cast<double> (y[i]);
+
+                if (std::abs (d) > result.maxAbs)
+                {
+                    result.maxAbs      = std::abs (d);
+                    result.maxPosition = pos + i;
+                }
+            }
+        }
+    }
+
+    const double count = static_cast<double> (juce::jmax<juce::int64> (1, result.numSamples * numChannels));
+
+    if (sumDiff > 0.0)
+    {
+        result.rmsDb = 10.0 * std::log10 (sumDiff / count);
+        result.signalToDifferenceDb = sumRef > 0.0 ? 10.0 * std::log10 (sumRef / sumDiff) : -200.0;
+    }
+
+    return juce::Result::ok();
+}
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+    Hisstory – OfflineRenderer.h
+
+    Renders audio files through HisstoryAudioProcessor without a host or a
+    message loop: the input is streamed through processBlock in large blocks
+    and the result written as it comes out.
+      • The output has the input's length and is sample-aligned with it: the
+        processor's latency is flushed by reading silence past the end of
+        the input, and the same number of samples is dropped from the start.
+      • Settings come from a saved plugin state (the XML a session stores)
+        and / or individual parameter values, so a setting made in a DAW
+        renders identically offline.
+      • Each render() builds its own processor, so one renderer can be
+        shared by several threads.
+      • The FFT backend is fixed (Settings::fftBackend), so a render is
+        reproducible from run to run.  The plugin's `automatic` choice is
+        timed once per process and may differ between runs.
+      • Long files can be split into segments rendered concurrently (see
+        Settings::segmentThreads).  The noise tracker and gain smoothing
+        are recurrences over the whole file, so each segment starts
+        preRollSeconds early to let them converge, and neighbouring
+        segments are joined by a crossfade.  The result is close to, not
+        identical with, a serial render; compare() measures by how much.
+      • Alternatively each processor can spread its own STFT over threads
+        (Settings::stftThreads), which is exact but scales less far.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FftBackend.h"
+#include <functional>
+#include <memory>
+
+class HisstoryAudioProcessor;
+
+//==============================================================================
+class OfflineRenderer
+{
+public:
+    struct Settings
+    {
+        /** processBlock size.  Large blocks cost nothing in latency offline
+            and keep the per-call overhead negligible. */
+        int blockSize = 32768;
+
+        /** Plugin state saved by getStateInformation() as XML (see
+            writeState()); applied first, so the options below override it. */
+        juce::File stateFile;
+
+        /** Parameter ID → value in the parameter's own units (dB, %, or
+            on / off for switches). */
+        juce::StringPairArray parameters;
+
+        int fftOrder   = 0;     // 0: from the state, or the default
+        int lowLatency = -1;    // −1: from the state; 0 off, 1 on
+
+        /** FFT implementation.  Backends agree only to about 1e-5, so the
+            default is a fixed one: `automatic` picks by timing, once per
+            process, and two runs can then render slightly different files. */
+        FftBackend::Kind fftBackend = FftBackend::Kind::juce;
+
+        /** Output bit depth; 32 writes floating point where the format
+            supports it (WAV, AIFF). */
+        int bitsPerSample = 24;
+
+        /** Segmented rendering: with more than one thread, files longer
+            than one segment are cut into segmentSeconds pieces, each
+            rendered by a fresh processor fed preRollSeconds of the input
+            before it (output discarded) and crossfaded over
+            crossfadeSeconds into the previous one.  Up to segmentThreads + 2
+            segments are held in memory at once.  The segmentation depends
+            only on these values, so the output is the same for any thread
+            count above one. */
+        int    segmentThreads   = 1;
+        double segmentSeconds   = 60.0;
+        double preRollSeconds   = 10.0;
+        double crossfadeSeconds = 0.05;
+
+        /** Threads for each processor's three-phase offline STFT (see
+            HisstoryAudioProcessor::setOfflineStftThreads); 0 leaves it
+            off.  Unlike segmenting, the output is bit-identical to a
+            serial render.  With segments, each processor gets its own. */
+        int stftThreads = 0;
+    };
+
+    struct Stats
+    {
+        juce::int64 numSamples     = 0;     // per channel, input = output
+        int         numChannels    = 0;
+        double      sampleRate     = 0.0;
+        int         latencySamples = 0;     // flushed and trimmed
+        double      processSeconds = 0.0;   // inside processBlock, summed over threads
+        double      totalSeconds   = 0.0;   // wall time, including decoding and encoding
+        int         numSegments    = 1;
+
+        double getAudioSeconds() const noexcept     { return sampleRate > 0.0 ? (double) numSamples / sampleRate : 0.0; }
+        double getRealTimeFactor() const noexcept   { return totalSeconds > 0.0 ? getAudioSeconds() / totalSeconds : 0.0; }
+    };
+
+    explicit OfflineRenderer (const Settings&);
+
+    /** Renders input to output (format from the output's extension),
+        replacing any existing file. */
+    juce::Result render (const juce::File& input, const juce::File& output, Stats& stats) const;
+
+    /** Writes the plugin state these settings produce, as XML usable with
+        Settings::stateFile. */
+    juce::Result writeState (const juce::File& destination) const;
+
+    //==========================================================================
+    /** How far one render is from another, e.g. a segmented render from a
+        serial one, over all channels. */
+    struct Difference
+    {
+        juce::int64 numSamples   = 0;       // per channel
+        double      maxAbs       = 0.0;     // largest sample difference
+        juce::int64 maxPosition  = 0;       // where it occurs
+        double      rmsDb        = -200.0;  // RMS of the difference, dBFS
+        double      signalToDifferenceDb = 200.0;  // reference RMS over difference RMS
+    };
+
+    /** Compares two files sample by sample; they must have the same length
+        and channel count. */
+    static juce::Result compare (const juce::File& rendered, const juce::File& reference, Difference& result);
+
+private:
+    struct Segment;
+    using Sink = std::function<bool (const juce::AudioBuffer<float>& block, int start, int count)>;
+
+    /** Applies the state file, parameters and engine options. */
+    juce::Result configure (HisstoryAudioProcessor&) const;
+
+    /** Builds, configures and prepares a processor for the input's layout. */
+    juce::Result createProcessor (std::unique_ptr<HisstoryAudioProcessor>& proc,
+                                  int numChannels, double sampleRate) const;
+
+    /** Feeds the input to the processor from inputStart and passes the
+        processed samples for output positions [outputStart, outputEnd) to
+        the sink, in order, in block-sized pieces.  Fails if the reader or
+        the sink does. */
+    juce::Result stream (juce::AudioFormatReader& reader, HisstoryAudioProcessor& proc,
+                         juce::int64 inputStart, juce::int64 outputStart, juce::int64 outputEnd,
+                         const Sink& sink, juce::int64& processTicks) const;
+
+    juce::Result renderSegments (const juce::File& input, juce::AudioFormatReader& reader,
+                                 juce::AudioFormatWriter& writer, Stats& stats) const;
+
+    /** Renders one segment into its buffer; runs on a segment worker. */
+    juce::Result renderSegment (const juce::File& input, Segment& segment, juce::int64& processTicks) const;
+
+    const Settings settings;
+
+    JUCE_DECLARE_NON_COPYABLE (OfflineRenderer)
+};
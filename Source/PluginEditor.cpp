@@ -280,13 +280,15 @@ float SpectrumDisplay::yToDb (float y) const
 
 // ── Spectrum data refresh ───────────────────────────────────────────────────
 
-void SpectrumDisplay::updateSpectrumData()
+void SpectrumDisplay::updateSpectrumData (const HisstoryAudioProcessor::DisplaySnapshot& newSnapshot)
 {
+    snapshot = &newSnapshot;
+
     constexpr float decay = 0.75f;
-    for (int i = 0; i < HisstoryAudioProcessor::numBins; ++i)
+    for (int i = 0; i < HisstoryAudioProcessor::displayNumBins; ++i)
     {
-        float inFS  = processor.inputSpectrumDB[i]  + fftNormDB;
-        float outFS = processor.outputSpectrumDB[i] + fftNormDB;
+        float inFS  = snapshot->inputSpectrumDB[i]  + fftNormDB;
+        float outFS = snapshot->outputSpectrumDB[i] + fftNormDB;
 
         dispInput[i]  = decay * dispInput[i]  + (1.0f - decay) * inFS;
         dispOutput[i] = decay * dispOutput[i] + (1.0f - decay) * outFS;
@@ -422,17 +424,17 @@ void SpectrumDisplay::drawGrid (juce::Graphics& g)
 
 void SpectrumDisplay::drawSpectrumCurve (
     juce::Graphics& g,
-    const std::array<float, HisstoryAudioProcessor::numBins>& data,
+    const std::array<float, HisstoryAudioProcessor::displayNumBins>& data,
     juce::Colour colour,
     float thickness)
 {
     const float sr   = processor.currentSampleRate.load();
-    const float binW = sr / static_cast<float> (HisstoryAudioProcessor::fftSize);
+    const float binW = sr / static_cast<float> (HisstoryAudioProcessor::displayFftSize);
 
     juce::Path path;
     bool started = false;
 
-    for (int bin = 1; bin < HisstoryAudioProcessor::numBins; bin += 2)
+    for (int bin = 1; bin < HisstoryAudioProcessor::displayNumBins; bin += 2)
     {
         float freq = static_cast<float> (bin) * binW;
         if (freq < analyzerMinFreq || freq > analyzerMaxFreq) continue;
@@ -456,7 +458,7 @@ void SpectrumDisplay::drawThresholdCurve (juce::Graphics& g)
 {
     const float sr = processor.currentSampleRate.load();
     const float globalThr = processor.apvts.getRawParameterValue ("threshold")->load();
-    const bool  hasProfile = processor.noiseProfileReady.load();
+    const bool  hasProfile = snapshot != nullptr && snapshot->noiseProfileReady;
     const bool  isAdaptive = processor.apvts.getRawParameterValue ("adaptive")->load() > 0.5f;
 
     juce::Path path;
@@ -473,9 +475,9 @@ void SpectrumDisplay::drawThresholdCurve (juce::Graphics& g)
         if (hasProfile)
         {
             int bin = juce::jlimit (0,
-                HisstoryAudioProcessor::numBins - 1,
-                static_cast<int> (freq / (sr / HisstoryAudioProcessor::fftSize) + 0.5f));
-            float noiseMagLin = processor.noiseProfileDisplay[bin];
+                HisstoryAudioProcessor::displayNumBins - 1,
+                static_cast<int> (freq / (sr / HisstoryAudioProcessor::displayFftSize) + 0.5f));
+            float noiseMagLin = snapshot->noiseProfile[bin];
             float noiseDB = juce::Decibels::gainToDecibels (noiseMagLin, -150.0f)
                           + fftNormDB;
             return noiseDB + offsetDB;
@@ -507,7 +509,7 @@ void SpectrumDisplay::drawBandPoints (juce::Graphics& g)
 {
     const float sr = processor.currentSampleRate.load();
     const float globalThr = processor.apvts.getRawParameterValue ("threshold")->load();
-    const bool  hasProfile = processor.noiseProfileReady.load();
+    const bool  hasProfile = snapshot != nullptr && snapshot->noiseProfileReady;
     const bool  isAdaptive = processor.apvts.getRawParameterValue ("adaptive")->load() > 0.5f;
 
     const bool bypassed = processor.apvts.getRawParameterValue ("bypass")->load() > 0.5f;
@@ -526,9 +528,9 @@ void SpectrumDisplay::drawBandPoints (juce::Graphics& g)
         if (hasProfile)
         {
             int bin = juce::jlimit (0,
-                HisstoryAudioProcessor::numBins - 1,
-                static_cast<int> (freq / (sr / HisstoryAudioProcessor::fftSize) + 0.5f));
-            float noiseMagLin = processor.noiseProfileDisplay[bin];
+                HisstoryAudioProcessor::displayNumBins - 1,
+                static_cast<int> (freq / (sr / HisstoryAudioProcessor::displayFftSize) + 0.5f));
+            float noiseMagLin = snapshot->noiseProfile[bin];
             float noiseDB = juce::Decibels::gainToDecibels (noiseMagLin, -150.0f)
                           + fftNormDB;
             effectiveDB = noiseDB + offsetDB;
@@ -568,7 +570,7 @@ void SpectrumDisplay::mouseDown (const juce::MouseEvent& e)
 
     const float sr = processor.currentSampleRate.load();
     const float globalThr = processor.apvts.getRawParameterValue ("threshold")->load();
-    const bool  hasProfile = processor.noiseProfileReady.load();
+    const bool  hasProfile = snapshot != nullptr && snapshot->noiseProfileReady;
     const bool  isAdaptive = processor.apvts.getRawParameterValue ("adaptive")->load() > 0.5f;
 
     for (int i = 0; i < HisstoryAudioProcessor::numBands; ++i)
@@ -584,9 +586,9 @@ void SpectrumDisplay::mouseDown (const juce::MouseEvent& e)
         if (hasProfile)
         {
             int bin = juce::jlimit (0,
-                HisstoryAudioProcessor::numBins - 1,
-                static_cast<int> (freq / (sr / HisstoryAudioProcessor::fftSize) + 0.5f));
-            float noiseMagLin = processor.noiseProfileDisplay[bin];
+                HisstoryAudioProcessor::displayNumBins - 1,
+                static_cast<int> (freq / (sr / HisstoryAudioProcessor::displayFftSize) + 0.5f));
+            float noiseMagLin = snapshot->noiseProfile[bin];
             float noiseDB = juce::Decibels::gainToDecibels (noiseMagLin, -150.0f)
                           + fftNormDB;
             effectiveDB = noiseDB + offsetDB;
@@ -618,7 +620,7 @@ void SpectrumDisplay::mouseDrag (const juce::MouseEvent& e)
 
     const float sr = processor.currentSampleRate.load();
     const float globalThr = processor.apvts.getRawParameterValue ("threshold")->load();
-    const bool  hasProfile = processor.noiseProfileReady.load();
+    const bool  hasProfile = snapshot != nullptr && snapshot->noiseProfileReady;
     const bool  isAdaptive = processor.apvts.getRawParameterValue ("adaptive")->load() > 0.5f;
 
     float targetDB = yToDb (e.position.y);
@@ -628,9 +630,9 @@ void SpectrumDisplay::mouseDrag (const juce::MouseEvent& e)
     {
         float freq = HisstoryAudioProcessor::bandFrequencies[draggingBand];
         int bin = juce::jlimit (0,
-            HisstoryAudioProcessor::numBins - 1,
-            static_cast<int> (freq / (sr / HisstoryAudioProcessor::fftSize) + 0.5f));
-        float noiseMagLin = processor.noiseProfileDisplay[bin];
+            HisstoryAudioProcessor::displayNumBins - 1,
+            static_cast<int> (freq / (sr / HisstoryAudioProcessor::displayFftSize) + 0.5f));
+        float noiseMagLin = snapshot->noiseProfile[bin];
         baseDB = juce::Decibels::gainToDecibels (noiseMagLin, -150.0f)
                + fftNormDB;
     }
@@ -682,7 +684,7 @@ void SpectrumDisplay::buildMelFilterbank()
     melFilters.resize (static_cast<size_t> (numMelBins));
 
     const float sr   = std::max (processor.currentSampleRate.load(), 1.0f);
-    const float binW = sr / static_cast<float> (HisstoryAudioProcessor::fftSize);
+    const float binW = sr / static_cast<float> (HisstoryAudioProcessor::displayFftSize);
 
     const float melMin = hzToMel (spectrogramMinFreq);
     const float melMax = hzToMel (std::min (spectrogramMaxFreq, sr * 0.5f));
@@ -699,7 +701,7 @@ void SpectrumDisplay::buildMelFilterbank()
         const float fHigh = melEdges[static_cast<size_t> (m + 2)];
 
         int binLow  = std::max (1, static_cast<int> (std::floor (fLow  / binW)));
-        int binHigh = std::min (HisstoryAudioProcessor::numBins - 1,
+        int binHigh = std::min (HisstoryAudioProcessor::displayNumBins - 1,
                                 static_cast<int> (std::ceil (fHigh / binW)));
 
         auto& filt = melFilters[static_cast<size_t> (m)];
@@ -1126,11 +1128,15 @@ HisstoryAudioProcessorEditor::HisstoryAudioProcessorEditor (
     applyCollapsedLayoutState();
     updateMacPeerWindowBehaviour();
     updateBypassVisualState (processor.apvts.getRawParameterValue ("bypass")->load() > 0.5f);
-    startTimerHz (30);
+
+    processor.addDisplaySubscriber();
+    startTimerHz (HisstoryAudioProcessor::displayRefreshHz);
 }
 
 HisstoryAudioProcessorEditor::~HisstoryAudioProcessorEditor()
 {
+    stopTimer();
+    processor.removeDisplaySubscriber();
     setLookAndFeel (nullptr);
 }
 
@@ -1371,7 +1377,7 @@ void HisstoryAudioProcessorEditor::updateBypassVisualState (bool bypassed)
 //==============================================================================
 //  Metrics computation
 //==============================================================================
-void HisstoryAudioProcessorEditor::updateMetrics()
+void HisstoryAudioProcessorEditor::updateMetrics (const HisstoryAudioProcessor::DisplaySnapshot& snapshot)
 {
     const bool bypassed = processor.apvts.getRawParameterValue ("bypass")->load() > 0.5f;
     if (bypassed)
@@ -1389,18 +1395,18 @@ void HisstoryAudioProcessorEditor::updateMetrics()
     }
 
     const float sr = processor.currentSampleRate.load();
-    const float binHz = sr / static_cast<float> (HisstoryAudioProcessor::fftSize);
+    const float binHz = sr / static_cast<float> (HisstoryAudioProcessor::displayFftSize);
 
     float inputMidPower  = 0.0f, outputMidPower  = 0.0f;
     float inputHfPower   = 0.0f, outputHfPower   = 0.0f;
     float inputTotalPower = 0.0f, outputTotalPower = 0.0f;
 
-    for (int bin = 1; bin < HisstoryAudioProcessor::numBins; ++bin)
+    for (int bin = 1; bin < HisstoryAudioProcessor::displayNumBins; ++bin)
     {
         float freq = static_cast<float> (bin) * binHz;
 
-        float inDB  = processor.inputSpectrumDB[bin]  + fftNormDB;
-        float outDB = processor.outputSpectrumDB[bin] + fftNormDB;
+        float inDB  = snapshot.inputSpectrumDB[bin]  + fftNormDB;
+        float outDB = snapshot.outputSpectrumDB[bin] + fftNormDB;
 
         float inPow  = std::pow (10.0f, inDB / 10.0f);
         float outPow = std::pow (10.0f, outDB / 10.0f);
@@ -1461,10 +1467,10 @@ void HisstoryAudioProcessorEditor::updateMetrics()
         metricOutputVal.setColour (juce::Label::textColourId, metricBad);
 
     // ── Harmonic Loss (percentage) ──────────────────────────────────────
-    //  Reads from the processor's atomic: fraction (0–1) of tonal energy
-    //  removed.  Displayed as percentage.  0% = perfect preservation.
+    //  Taken from the snapshot: fraction (0–1) of tonal energy removed.
+    //  Displayed as percentage.  0% = perfect preservation.
     {
-        const float rawLoss = processor.metricHarmonicLossRatio.load();
+        const float rawLoss = snapshot.harmonicLossRatio;
         constexpr float hlrSmooth = 0.92f;
         smoothHLR = hlrSmooth * smoothHLR + (1.0f - hlrSmooth) * rawLoss;
 
@@ -1487,12 +1493,22 @@ void HisstoryAudioProcessorEditor::updateMetrics()
 //==============================================================================
 void HisstoryAudioProcessorEditor::timerCallback()
 {
-    spectrumDisplay.updateSpectrumData();
+    // Spectra and metrics only move when the audio thread has published a
+    // new snapshot; the smoothing below would otherwise re-apply stale data.
+    const auto& snapshot = processor.getLatestDisplaySnapshot();
+    const bool  isNewSnapshot = snapshot.version != lastSnapshotVersion;
+    lastSnapshotVersion = snapshot.version;
+
+    if (isNewSnapshot)
+        spectrumDisplay.updateSpectrumData (snapshot);
+
     spectrumDisplay.repaint();
 
     // Slider text boxes update automatically via JUCE text-from-value
 
     const bool bypassed = processor.apvts.getRawParameterValue ("bypass")->load() > 0.5f;
     updateBypassVisualState (bypassed);
-    updateMetrics();
+
+    if (isNewSnapshot)
+        updateMetrics (snapshot);
 }
@@ -21,7 +21,8 @@
 namespace HisstoryConstants
 {
     // FFT normalisation offset: -20 * log10(fftSize / 2)
-    // For fftSize = 4096: -20 * log10(2048) ≈ -66.2
+    // For displayFftSize = 4096: -20 * log10(2048) ≈ -66.2 (engine spectra
+    // of other sizes are rescaled onto this grid before display)
     static constexpr float fftNormDB = -66.2f;
 }
 
@@ -98,7 +99,9 @@ public:
     void mouseDrag (const juce::MouseEvent&) override;
     void mouseUp   (const juce::MouseEvent&) override;
 
-    void updateSpectrumData();
+    /** Takes in a new display snapshot; the display keeps referring to it
+        (for the noise profile) until the next call. */
+    void updateSpectrumData (const HisstoryAudioProcessor::DisplaySnapshot& newSnapshot);
 
     /** Toggle between spectrum analyser and spectrogram views. */
     void setSpectrogramMode (bool enabled);
@@ -110,9 +113,10 @@ public:
 
 private:
     HisstoryAudioProcessor& processor;
+    const HisstoryAudioProcessor::DisplaySnapshot* snapshot = nullptr;
 
-    std::array<float, HisstoryAudioProcessor::numBins> dispInput  {};
-    std::array<float, HisstoryAudioProcessor::numBins> dispOutput {};
+    std::array<float, HisstoryAudioProcessor::displayNumBins> dispInput  {};
+    std::array<float, HisstoryAudioProcessor::displayNumBins> dispOutput {};
 
     int draggingBand = -1;
 
@@ -124,7 +128,7 @@ private:
     void drawGrid           (juce::Graphics&);
     void drawLegend         (juce::Graphics&);
     void drawSpectrumCurve  (juce::Graphics&, const std::array<float,
-                             HisstoryAudioProcessor::numBins>& data,
+                             HisstoryAudioProcessor::displayNumBins>& data,
                              juce::Colour colour, float thickness);
     void drawThresholdCurve (juce::Graphics&);
     void drawBandPoints     (juce::Graphics&);
@@ -185,7 +189,7 @@ public:
 
 private:
     void timerCallback() override;
-    void updateMetrics();
+    void updateMetrics (const HisstoryAudioProcessor::DisplaySnapshot& snapshot);
     void updateBypassVisualState (bool bypassed);
     void applyCollapsedLayoutState();
     void updateMacPeerWindowBehaviour();
@@ -228,6 +232,7 @@ private:
     float smoothOutput       = 0.0f;
     float smoothHLR          = 0.0f;
     bool bypassVisualState   = false;
+    uint64_t lastSnapshotVersion = 0;
 
     using SliderAttach = juce::AudioProcessorValueTreeState::SliderAttachment;
     using ButtonAttach = juce::AudioProcessorValueTreeState::ButtonAttachment;
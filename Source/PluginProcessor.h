@@ -13,16 +13,26 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "ChannelWorkerPool.h"
+#include "FftBackend.h"
+#include "ProcessTiming.h"
+#include "TripleBuffer.h"
 #include <array>
 #include <atomic>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 //==============================================================================
-class HisstoryAudioProcessor : public juce::AudioProcessor
+class HisstoryAudioProcessor : public juce::AudioProcessor,
+                               private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==========================================================================
-    HisstoryAudioProcessor();
+    /** fftOrder picks the STFT size (minFftOrder–maxFftOrder); see setFftOrder(). */
+    explicit HisstoryAudioProcessor (int fftOrder = defaultFftOrder);
     ~HisstoryAudioProcessor() override;
 
     //── AudioProcessor overrides ──────────────────────────────────────────────
@@ -30,6 +40,8 @@ public:
     void   releaseResources() override;
     bool   isBusesLayoutSupported (const BusesLayout&) const override;
     void   processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void   processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool   supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool   hasEditor() const override { return true; }
@@ -51,12 +63,29 @@ public:
     //==========================================================================
     //  DSP constants
     //==========================================================================
-    static constexpr int fftOrder  = 12;
-    static constexpr int fftSize   = 1 << fftOrder;         // 4096
-    static constexpr int hopSize   = fftSize / 4;            // 1024 (75 % overlap)
-    static constexpr int numBins   = fftSize / 2 + 1;        // 2049
+    /** Supported STFT sizes: 1024 to 16384 points, 75 % overlap.  Each order
+        is a separate Engine instantiation (SpectralEngine.h). */
+    static constexpr int minFftOrder     = 10;
+    static constexpr int maxFftOrder     = 14;
+    static constexpr int defaultFftOrder = 12;                        // 4096
+
+    /** The editor's spectra are always on this grid, whatever the FFT size. */
+    static constexpr int displayFftSize  = 1 << defaultFftOrder;      // 4096
+    static constexpr int displayNumBins  = displayFftSize / 2 + 1;    // 2049
+
+    /** Hop of the low-latency mode; its latency is twice this (256 samples). */
+    static constexpr int lowLatencyHopSize = 128;
+
     static constexpr int numBands  = 6;
 
+    /** Largest bus width accepted (covers 7.1.4 and 24-track transfers). */
+    static constexpr int maxNumChannels = 32;
+
+    /** Below this many channels the worker pool is never started: mono and
+        stereo are a single transform unit per hop, so there is nothing to
+        spread across threads. */
+    static constexpr int minChannelsForWorkers = 4;
+
     /** Fixed centre-frequencies for the 6 threshold-curve control-points.
         Focused on the hiss range (4 kHz–12 kHz). */
     static constexpr std::array<float, numBands> bandFrequencies
@@ -65,26 +94,68 @@ public:
     //==========================================================================
     //  Data shared with the Editor (lock-free)
     //==========================================================================
-    float inputSpectrumDB  [numBins] {};
-    float outputSpectrumDB [numBins] {};
+    /** Everything the editor draws, published together by the audio thread
+        once per processed hop (see getLatestDisplaySnapshot()). */
+    struct DisplaySnapshot
+    {
+        uint64_t version = 0;                       // 0 = nothing published yet
 
-    float noiseProfileDisplay [numBins] {};
-    std::atomic<bool> noiseProfileReady { false };
+        float inputSpectrumDB  [displayNumBins] {};
+        float outputSpectrumDB [displayNumBins] {};
 
-    std::atomic<float> currentSampleRate { 44100.0f };
+        float noiseProfile [displayNumBins] {};
+        bool  noiseProfileReady = false;
+
+        /** Noise Purity metric: fraction (0–1) of removed energy that came from
+            stationary (noise-like) bins.  1.0 = all removed content was noise,
+            0.0 = all removed content was music. */
+        float noisePurity = 0.0f;
 
-    /** Noise Purity metric: fraction (0–1) of removed energy that came from
-        stationary (noise-like) bins.  1.0 = all removed content was noise,
-        0.0 = all removed content was music. */
-    std::atomic<float> metricNoisePurity { 0.0f };
+        /** Harmonic Loss: fraction (0–1) of tonal energy removed by the de-hisser.
+            0.0 = no loss (perfect preservation); higher = more loss. */
+        float harmonicLossRatio = 0.0f;
+
+        /** Residual Spectral Flux: normalised frame-to-frame change of the
+            residual (removed) spectrum.  Low = noise-like (good), high = musical (bad). */
+        float residualFlux = 0.0f;
+
+        /** Output / input power (dB) over the bins nearest each band
+            control point; 0 = untouched. */
+        float bandReductionDB [numBands] {};
+
+        /** Bins classified as tonal (peaks ≥ 7 dB over their neighbours,
+            plus the bins either side) in the last analysed frame. */
+        int tonalBinCount = 0;
+
+        /** Display frames dropped because the analysis worker fell behind. */
+        uint64_t droppedFrames = 0;
+    };
+
+    /** Picks up the most recently published snapshot, if there is a new one,
+        and returns the current one.  A new frame has a different version.
+        Single reader: call only from the message thread.  The reference stays
+        valid, and unchanged, until the next call. */
+    const DisplaySnapshot& getLatestDisplaySnapshot() noexcept
+    {
+        displaySnapshots.acquireLatest();
+        return displaySnapshots.getReadBuffer();
+    }
 
-    /** Harmonic Loss: fraction (0–1) of tonal energy removed by the de-hisser.
-        0.0 = no loss (perfect preservation); higher = more loss. */
-    std::atomic<float> metricHarmonicLossRatio { 0.0f };
+    /** Display spectra and quality metrics are only computed while at least
+        one subscriber (normally the open editor) is registered, and then at
+        most about displayRefreshHz times a second.  Headless renders and
+        closed-editor sessions skip that work entirely. */
+    static constexpr int displayRefreshHz = 30;
 
-    /** Residual Spectral Flux: normalised frame-to-frame change of the
-        residual (removed) spectrum.  Low = noise-like (good), high = musical (bad). */
-    std::atomic<float> metricResidualFlux { 0.0f };
+    void addDisplaySubscriber() noexcept    { displaySubscribers.fetch_add (1, std::memory_order_relaxed); }
+    void removeDisplaySubscriber() noexcept { displaySubscribers.fetch_sub (1, std::memory_order_relaxed); }
+
+    /** Snapshots are produced by a background analysis thread.  Blocks until
+        it has caught up with every frame pushed so far (for tests and
+        offline hosts); returns false on timeout. */
+    bool waitForDisplayAnalysis (int timeoutMs = 1000) const;
+
+    std::atomic<float> currentSampleRate { 44100.0f };
 
     /** STFT normalisation factor – public so the test harness can inspect it. */
     float windowCorrection = 2.0f / 3.0f;
@@ -93,6 +164,151 @@ public:
         Public so the editor can draw the threshold curve. */
     float interpolateBandOffset (float freqHz) const;
 
+    /** Selects the scalar reference implementation of the per-bin spectral
+        gate instead of the vectorised kernels.  Intended for tests and for
+        A/B-ing numerical changes; both paths agree to within float rounding. */
+    void setUseReferenceSpectrumKernels (bool shouldUseReference) noexcept
+    {
+        useReferenceKernels.store (shouldUseReference);
+    }
+
+    /** Runs the vectorised per-bin stages as a cache-tiled wavefront
+        (HisstoryKernels::processFrameTiled) instead of one stage at a time
+        over the whole spectrum.  The output is bit-identical; off by
+        default because `Benchmark --kernels` shows no consistent gain
+        while the per-bin arrays fit in L2, which they do at every FFT size
+        on current desktop CPUs. */
+    void setUseTiledFrameUpdate (bool shouldTile) noexcept
+    {
+        useTiledFrameUpdate.store (shouldTile);
+    }
+
+    /** Enables the paired transform, which packs adjacent channels (L/R,
+        and 2/3, 4/5 … for multichannel) into one complex FFT instead of two
+        real FFTs.  Output matches the per-channel path to within float
+        rounding; a lone odd channel (or mono) uses the real FFT.  On by
+        default. */
+    void setUsePairedStereoFFT (bool shouldPair) noexcept
+    {
+        usePairedStereoFFT.store (shouldPair);
+    }
+
+    /** While bypass is fully engaged the STFT stops and only the latency
+        delay line runs.  With tracking on (the default) a forward FFT every
+        few hops keeps the noise tracker and music/noise statistics current,
+        and the editor's input spectrum live, so un-bypassing picks up where
+        the material is; off, a bypassed instance costs only the delay. */
+    void setTrackNoiseWhileBypassed (bool shouldTrack) noexcept
+    {
+        trackNoiseWhileBypassed.store (shouldTrack);
+    }
+
+    /** Skips the inverse FFT of frames whose gains are all within 0.1 % of
+        unity and overlap-adds their windowed input instead; the output then
+        differs from the full path by at most −60 dB relative to the frame
+        (see SpectralEngine.h).  On by default. */
+    void setSkipUnityGainFrames (bool shouldSkip) noexcept
+    {
+        skipUnityGainFrames.store (shouldSkip);
+    }
+
+    /** STFT frames run since prepareToPlay(), counted per channel: all
+        frames that fell due while the wet path was active, and how many of
+        them were skipped as silent or took the unity-gain shortcut.  May be
+        read from any thread. */
+    struct FrameStatistics
+    {
+        uint64_t total     = 0;
+        uint64_t silent    = 0;
+        uint64_t unityGain = 0;
+    };
+
+    FrameStatistics getFrameStatistics() const noexcept
+    {
+        return { framesTotal.load (std::memory_order_relaxed),
+                 framesSilent.load (std::memory_order_relaxed),
+                 framesUnityGain.load (std::memory_order_relaxed) };
+    }
+
+    /** Callback and per-stage timing since prepareToPlay() or the last
+        resetTimingStatistics() (see ProcessTiming.h).  May be read from any
+        thread; all zeros in builds with HISSTORY_ENABLE_TIMING=0. */
+    ProcessTiming::Statistics getTimingStatistics() const noexcept { return timing.getStatistics(); }
+
+    /** Clears the timing statistics at the start of the next callback. */
+    void resetTimingStatistics() noexcept                          { timing.reset(); }
+
+    /** Callbacks longer than this fraction of their block's duration count
+        as deadline misses (default 0.5). */
+    void setDeadlineFraction (float fraction) noexcept             { timing.setDeadlineFraction (fraction); }
+    float getDeadlineFraction() const noexcept                     { return timing.getDeadlineFraction(); }
+
+    /** Number of worker threads used to run channel transforms concurrently
+        once the bus has at least minChannelsForWorkers channels.  0 (the
+        default) keeps everything on the audio thread.  Takes effect at the
+        next prepareToPlay().  Output is identical either way. */
+    void setChannelWorkerThreads (int numThreads) noexcept
+    {
+        requestedWorkerThreads.store (std::max (0, numThreads));
+    }
+
+    int getNumChannelWorkerThreads() const noexcept { return channelWorkers.getNumThreads(); }
+
+    /** Offline rendering: runs each processBlock() through the three-phase
+        STFT on numThreads threads (the calling one included) – every
+        frame's forward FFT in parallel, then the per-bin recurrences in
+        frame order, then every inverse FFT in parallel and the overlap-add
+        one channel per thread.  Output is bit-identical to the normal
+        path.  Frames are shared out per block (up to 32 hops at a time),
+        so use blocks of many hops.  Blocks that involve a bypass
+        transition, and 64-bit buffers, take the normal path.  Not real-time
+        safe: keep 0 (the default, off) for live use.  Takes effect at the
+        next prepareToPlay(). */
+    void setOfflineStftThreads (int numThreads) noexcept
+    {
+        requestedOfflineThreads.store (std::max (0, numThreads));
+    }
+
+    int getNumOfflineStftThreads() const noexcept { return offlineStftThreads; }
+
+    /** Selects the STFT size as an FFT order (clamped to minFftOrder–
+        maxFftOrder).  Takes effect at the next prepareToPlay(), which also
+        reports the new latency (one FFT length); saved with the plugin state. */
+    void setFftOrder (int newOrder) noexcept
+    {
+        requestedFftOrder.store (juce::jlimit (minFftOrder, maxFftOrder, newOrder));
+    }
+
+    /** The order of the current engine (a setFftOrder() change shows up
+        after the next prepareToPlay()). */
+    int getFftOrder() const noexcept;
+    int getFftSize() const noexcept { return 1 << getFftOrder(); }
+
+    /** Switches to asymmetric analysis / synthesis windows with a short
+        synthesis window, cutting latency from the FFT size to
+        2 · lowLatencyHopSize samples while keeping the FFT's frequency
+        resolution.  Frames then run every lowLatencyHopSize samples, so CPU
+        rises accordingly.  Takes effect at the next prepareToPlay(), which
+        reports the new latency; saved with the plugin state. */
+    void setLowLatencyMode (bool shouldUseLowLatency) noexcept
+    {
+        requestedLowLatency.store (shouldUseLowLatency);
+    }
+
+    bool isLowLatencyMode() const noexcept;
+
+    /** Picks the FFT implementation (FftBackend.h).  With `automatic`, the
+        default, each FFT size uses the backend measured fastest on this CPU
+        (timed once per size and process, at the first prepareToPlay that
+        needs it).  Takes effect at the next prepareToPlay(). */
+    void setFftBackend (FftBackend::Kind kind) noexcept
+    {
+        requestedFftBackend.store (kind);
+    }
+
+    /** The backend the current engine runs, with `automatic` resolved. */
+    FftBackend::Kind getFftBackend() const noexcept;
+
     /** In adaptive mode, band offsets are boosted by this amount so that the
         default -30 dB offsets become neutral (0 dB effective). */
     static constexpr float adaptiveBandBoost = 20.0f;
@@ -105,51 +321,50 @@ public:
 
 private:
     //==========================================================================
-    //  FFT engine & window
+    //  STFT engine
+    //  Everything sized by the FFT lives in an Engine<order> (SpectralEngine.h);
+    //  the processor keeps parameters, bypass / silence state and the data
+    //  shared with the editor.
     //==========================================================================
-    juce::dsp::FFT                         forwardFFT { fftOrder };
-    juce::dsp::WindowingFunction<float>    hannWindow
-        { static_cast<size_t>(fftSize),
-          juce::dsp::WindowingFunction<float>::hann,
-          false  /* normalise = false: standard Hann (peak = 1.0, COLA = 1.5 for Hann²) */ };
+    struct EngineBase;
+    template <int FftOrder, bool LowLatency> class Engine;
 
-    //==========================================================================
-    //  Per-channel STFT state
-    //==========================================================================
-    struct ChannelState
-    {
-        std::array<float, fftSize>      inputFifo {};
-        std::array<float, fftSize * 2>  outputAccum {};
-        std::array<float, fftSize>      inputDelayBuf {};  // delay line for output clamping
-        int   fifoWritePos    = 0;
-        int   outputReadPos   = 0;
-        int   delayWritePos   = 0;
-        int   samplesUntilHop = hopSize;
-        std::array<float, numBins>      prevGain {};
-        float signalLevel     = 0.0f;   // smoothed frame-level (dB) for quiet detection
-
-        void reset();
-    };
+    std::unique_ptr<EngineBase>   engine;
+    std::atomic<int>              requestedFftOrder   { defaultFftOrder };
+    std::atomic<bool>             requestedLowLatency { false };
+    std::atomic<FftBackend::Kind> requestedFftBackend { FftBackend::Kind::automatic };
+    int                           numPreparedChannels = 0;
+
+    // State-tree properties for the engine selection
+    static constexpr const char* fftOrderPropertyID   = "fftOrder";
+    static constexpr const char* lowLatencyPropertyID = "lowLatency";
 
-    std::array<ChannelState, 2> channels;
+    static std::unique_ptr<EngineBase> createEngine (HisstoryAudioProcessor&, int fftOrder, bool lowLatency);
 
     //==========================================================================
-    //  Noise profile
+    //  Channel transforms: stereo pairing and the worker pools
     //==========================================================================
-    std::array<float, numBins>  noiseProfile {};
+    std::atomic<bool> usePairedStereoFFT     { true };
+    std::atomic<int>  requestedWorkerThreads { 0 };
+    ChannelWorkerPool channelWorkers;
+
+    // Three-phase offline STFT: offlineStftThreads lanes, the caller plus
+    // offlineWorkers' threads.  0 = off.
+    std::atomic<int>  requestedOfflineThreads { 0 };
+    int               offlineStftThreads = 0;
+    ChannelWorkerPool offlineWorkers;
 
     //==========================================================================
-    //  Stationarity tracking (for Noise Purity metric)
-    //  Running exponential averages of magnitude and magnitude² per bin.
-    //  The coefficient of variation (stddev / mean) indicates how stationary
-    //  a bin is: low CV = noise-like (stationary), high CV = music-like.
+    //  Display analysis (AnalysisWorker.h) and noise-profile resets
+    //  (forwarded to the engine, which owns the profile)
     //==========================================================================
-    std::array<float, numBins>  runningMean   {};
-    std::array<float, numBins>  runningMeanSq {};
-    float smoothedNoisePurity = 0.5f;
-    float smoothedHLR         = 0.0f;
-    float smoothedResFlux     = 0.0f;
-    std::array<float, numBins>  prevResidualMag {};
+    /** Written only by the analysis worker's thread (declared first so it
+        outlives the worker). */
+    TripleBuffer<DisplaySnapshot> displaySnapshots;
+    std::atomic<int>              displaySubscribers { 0 };
+
+    class AnalysisWorker;
+    std::unique_ptr<AnalysisWorker> analysisWorker;
 
     /** Generate a synthetic hiss-shaped default profile so the plugin
         works immediately (before the user presses Learn). */
@@ -171,22 +386,68 @@ private:
 
     //==========================================================================
     //  New-track / silence detection
+    //  Both thresholds are mean power per sample, compared against two
+    //  separate energies the engine sums while it moves the samples anyway:
+    //    silentFramePower – analysis frames whose *input* is below −100 dBFS
+    //                       are not processed (per-hop FIFO energy)
+    //    silenceGapPower  – blocks whose *output* is below −60 dBFS count
+    //                       towards a gap (getBlockOutputEnergy)
     //==========================================================================
+    static constexpr float silentFramePower = 1.0e-10f;
+    static constexpr float silenceGapPower  = 1.0e-6f;
+
     int  silenceSampleCount = 0;
     bool wasInSilence       = false;
     bool lastAdaptiveState  = true;
 
     //==========================================================================
-    //  Pre-computed per-bin threshold multiplier
+    //  Per-bin threshold table versioning
+    //  The engine's threshold multipliers are rebuilt when
+    //  thresholdParamsVersion moves, which the parameter listener bumps for
+    //  threshold / band / adaptive changes.
     //==========================================================================
-    std::array<float, numBins> perBinThreshold {};
+    static constexpr const char* thresholdParameterIDs[]
+        { "threshold", "adaptive", "band1", "band2", "band3", "band4", "band5", "band6" };
+
+    std::atomic<uint32_t> thresholdParamsVersion { 1 };
+    uint32_t              builtThresholdVersion  = 0;
+
+    void parameterChanged (const juce::String& parameterID, float newValue) override;
 
     //==========================================================================
     //  Internal helpers
     //==========================================================================
-    void  processSTFTFrame   (ChannelState& ch, bool updateSharedData, int numActiveChannels = 1);
-    void  processSpectrum    (float* fftData, ChannelState& ch, bool updateSharedData, int numActiveChannels = 1);
-    void  updatePerBinThreshold();
+    /** Shared body of both processBlock overloads. */
+    template <typename SampleType>
+    void  processSamples (juce::AudioBuffer<SampleType>& buffer);
+
+    std::atomic<bool> useReferenceKernels     { false };
+    std::atomic<bool> useTiledFrameUpdate     { false };
+    std::atomic<bool> trackNoiseWhileBypassed { true };
+    std::atomic<bool> skipUnityGainFrames     { true };
+
+    //==========================================================================
+    //  Frame statistics (getFrameStatistics); the audio thread is the only
+    //  writer, adding once per hop.
+    //==========================================================================
+    std::atomic<uint64_t> framesTotal     { 0 };
+    std::atomic<uint64_t> framesSilent    { 0 };
+    std::atomic<uint64_t> framesUnityGain { 0 };
+
+    void countFrames (uint64_t total, uint64_t silent, uint64_t unityGain) noexcept
+    {
+        if (total == 0)
+            return;
+
+        framesTotal    .store (framesTotal    .load (std::memory_order_relaxed) + total,     std::memory_order_relaxed);
+        framesSilent   .store (framesSilent   .load (std::memory_order_relaxed) + silent,    std::memory_order_relaxed);
+        framesUnityGain.store (framesUnityGain.load (std::memory_order_relaxed) + unityGain, std::memory_order_relaxed);
+    }
+
+    //==========================================================================
+    //  Callback timing (getTimingStatistics); the engine adds its stages
+    //==========================================================================
+    ProcessTiming timing;
 
     //==========================================================================
     //  Cached raw-parameter pointers
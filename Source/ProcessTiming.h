@@ -0,0 +1,257 @@
+/*
+  ==============================================================================
+    Hisstory – ProcessTiming.h
+
+    Lock-free timing of the audio callback, for the editor and CLI tools.
+      • Per callback: wall time, a fixed log2 histogram of it, and a count of
+        callbacks that overran a configurable fraction of the block duration.
+      • Per stage (FIFO I/O, forward FFT, processSpectrum, inverse FFT,
+        overlap-add): accumulated time.  Transforms that run on the channel
+        worker pool are summed over threads, so with workers the stages can
+        add up to more than the callbacks' wall time; work outside the five
+        stages (parameters, bypass tracking) shows only in the total.
+      • The audio thread is the only writer.  Counters are relaxed atomics
+        published once per callback, so readers on any thread never block
+        it; a reading may straddle a callback, but every counter in it is
+        one the audio thread actually wrote.
+    Building with HISSTORY_ENABLE_TIMING=0 compiles every measurement out:
+    no clock reads, no stores, and getStatistics() returns zeros.
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#ifndef HISSTORY_ENABLE_TIMING
+ #define HISSTORY_ENABLE_TIMING 1
+#endif
+
+//==============================================================================
+class ProcessTiming
+{
+public:
+    static constexpr bool enabled = HISSTORY_ENABLE_TIMING != 0;
+
+    using Ticks = int64_t;
+
+    enum Stage
+    {
+        fifoStage,          // input FIFO / delay line in, clamp and mix out
+        forwardFftStage,    // windowing and forward transforms
+        spectrumStage,      // processSpectrum (incl. silent and unity-gain checks)
+        inverseFftStage,    // inverse transforms
+        overlapAddStage,    // synthesis window and overlap-add
+        numStages
+    };
+
+    /** Bucket 0 holds callbacks under 1 µs; bucket b ≥ 1 those from
+        2^(b−1) µs up to 2^b µs; the last bucket is open-ended (≥ 262 ms). */
+    static constexpr int numHistogramBuckets = 20;
+
+    static const char* getStageName (int stage) noexcept
+    {
+        static constexpr const char* names[numStages]
+            { "FIFO I/O", "forward FFT", "processSpectrum", "inverse FFT", "overlap-add" };
+        return juce::isPositiveAndBelow (stage, (int) numStages) ? names[stage] : "";
+    }
+
+    /** Upper edge of a histogram bucket in seconds (infinite for the last). */
+    static double getBucketUpperSeconds (int bucket) noexcept
+    {
+        return bucket >= numHistogramBuckets - 1 ? std::numeric_limits<double>::infinity()
+                                                 : static_cast<double> (1 << bucket) * 1.0e-6;
+    }
+
+    struct Statistics
+    {
+        uint64_t callbacks      = 0;
+        uint64_t deadlineMisses = 0;    // callbacks over deadlineFraction · block duration
+        uint64_t samples        = 0;    // per channel, over all callbacks
+
+        double totalSeconds = 0.0;      // wall time of all callbacks
+        double maxSeconds   = 0.0;      // slowest single callback
+
+        std::array<double,   numStages>           stageSeconds {};
+        std::array<uint64_t, numHistogramBuckets> histogram {};
+    };
+
+    //── Any thread ────────────────────────────────────────────────────────────
+    Statistics getStatistics() const noexcept
+    {
+        Statistics s;
+
+        if constexpr (enabled)
+        {
+            const auto seconds = [] (Ticks t) { return juce::Time::highResolutionTicksToSeconds (t); };
+
+            s.callbacks      = callbacks     .load (std::memory_order_relaxed);
+            s.deadlineMisses = deadlineMisses.load (std::memory_order_relaxed);
+            s.samples        = samples       .load (std::memory_order_relaxed);
+            s.totalSeconds   = seconds (totalTicks.load (std::memory_order_relaxed));
+            s.maxSeconds     = seconds (maxTicks  .load (std::memory_order_relaxed));
+
+            for (int i = 0; i < numStages; ++i)
+                s.stageSeconds[(size_t) i] = seconds (stageTicks[(size_t) i].load (std::memory_order_relaxed));
+
+            for (int i = 0; i < numHistogramBuckets; ++i)
+                s.histogram[(size_t) i] = histogram[(size_t) i].load (std::memory_order_relaxed);
+        }
+
+        return s;
+    }
+
+    /** Clears the statistics at the start of the next callback (the audio
+        thread owns the counters, so it does the clearing). */
+    void reset() noexcept                       { resetRequested.store (true, std::memory_order_relaxed); }
+
+    /** A callback misses its deadline when it takes longer than this
+        fraction of its block's duration.  Default 0.5: the host and other
+        plugins share the rest. */
+    void setDeadlineFraction (float fraction) noexcept  { deadlineFraction.store (std::max (0.0f, fraction)); }
+    float getDeadlineFraction() const noexcept          { return deadlineFraction.load(); }
+
+    //── Audio thread (and prepareToPlay) ──────────────────────────────────────
+    static Ticks now() noexcept
+    {
+        if constexpr (enabled)
+            return juce::Time::getHighResolutionTicks();
+        else
+            return 0;
+    }
+
+    /** dest += time since start.  For per-unit slots on worker threads. */
+    static void addElapsed (Ticks& dest, Ticks start) noexcept
+    {
+        if constexpr (enabled)
+            dest += now() - start;
+    }
+
+    /** Clears everything and sets the block-duration scale.  Not concurrent
+        with callbacks. */
+    void prepare (double sampleRate) noexcept
+    {
+        ticksPerSample = static_cast<double> (juce::Time::getHighResolutionTicksPerSecond()) / sampleRate;
+        clear();
+        resetRequested.store (false, std::memory_order_relaxed);
+    }
+
+    /** Adds to a stage of the current callback. */
+    void addStage (Stage stage, Ticks elapsed) noexcept
+    {
+        if constexpr (enabled)
+            pendingStageTicks[(size_t) stage] += elapsed;
+    }
+
+    /** Times one processBlock. */
+    class ScopedCallback
+    {
+    public:
+        ScopedCallback (ProcessTiming& t, int blockSamples) noexcept
+            : timing (t), numSamples (blockSamples), start (t.beginCallback()) {}
+
+        ~ScopedCallback() noexcept   { timing.endCallback (start, numSamples); }
+
+    private:
+        ProcessTiming& timing;
+        const int      numSamples;
+        const Ticks    start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCallback)
+    };
+
+    /** Times a block of the audio thread's own work as one stage. */
+    class ScopedStage
+    {
+    public:
+        ScopedStage (ProcessTiming& t, Stage s) noexcept : timing (t), stage (s), start (now()) {}
+        ~ScopedStage() noexcept      { timing.addStage (stage, now() - start); }
+
+    private:
+        ProcessTiming& timing;
+        const Stage    stage;
+        const Ticks    start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedStage)
+    };
+
+private:
+    Ticks beginCallback() noexcept
+    {
+        if constexpr (enabled)
+        {
+            if (resetRequested.load (std::memory_order_relaxed)
+                 && resetRequested.exchange (false, std::memory_order_relaxed))
+                clear();
+        }
+
+        return now();
+    }
+
+    void endCallback (Ticks start, int numSamples) noexcept
+    {
+        if constexpr (enabled)
+        {
+            const Ticks elapsed = now() - start;
+
+            const auto add = [] (auto& counter, auto amount)
+            {
+                counter.store (counter.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            };
+
+            add (callbacks,  uint64_t (1));
+            add (samples,    static_cast<uint64_t> (numSamples));
+            add (totalTicks, elapsed);
+
+            if (elapsed > maxTicks.load (std::memory_order_relaxed))
+                maxTicks.store (elapsed, std::memory_order_relaxed);
+
+            const double deadline = deadlineFraction.load (std::memory_order_relaxed) * ticksPerSample * numSamples;
+            if (static_cast<double> (elapsed) > deadline)
+                add (deadlineMisses, uint64_t (1));
+
+            // Bucket from the bit length of the whole microseconds.
+            auto micros = static_cast<uint64_t> (juce::Time::highResolutionTicksToSeconds (elapsed) * 1.0e6);
+            int bucket = 0;
+            for (; micros > 0 && bucket < numHistogramBuckets - 1; micros >>= 1)
+                ++bucket;
+
+            add (histogram[(size_t) bucket], uint64_t (1));
+
+            for (int i = 0; i < numStages; ++i)
+            {
+                add (stageTicks[(size_t) i], pendingStageTicks[(size_t) i]);
+                pendingStageTicks[(size_t) i] = 0;
+            }
+        }
+    }
+
+    void clear() noexcept
+    {
+        callbacks = 0;  deadlineMisses = 0;  samples = 0;
+        totalTicks = 0; maxTicks = 0;
+
+        for (auto& t : stageTicks)   t = 0;
+        for (auto& h : histogram)    h = 0;
+        pendingStageTicks.fill (0);
+    }
+
+    std::atomic<uint64_t> callbacks      { 0 };
+    std::atomic<uint64_t> deadlineMisses { 0 };
+    std::atomic<uint64_t> samples        { 0 };
+    std::atomic<Ticks>    totalTicks     { 0 };
+    std::atomic<Ticks>    maxTicks       { 0 };
+
+    std::array<std::atomic<Ticks>,    numStages>           stageTicks {};
+    std::array<std::atomic<uint64_t>, numHistogramBuckets> histogram {};
+
+    std::array<Ticks, numStages> pendingStageTicks {};     // audio thread only
+    double                       ticksPerSample = 0.0;     // set in prepare
+
+    std::atomic<bool>  resetRequested   { false };
+    std::atomic<float> deadlineFraction { 0.5f };
+};
@@ -0,0 +1,334 @@
+/*
+  ==============================================================================
+    Render.cpp – hisstory-render, the offline command-line renderer.
+
+    hisstory-render <input> <output> [options]
+      --state <file.xml>       plugin state to start from (see --save-state)
+      --set <id>=<value>       parameter in its own units; repeatable, e.g.
+                               --set reduction=18 --set adaptive=off
+      --block <samples>        processBlock size (default 32768)
+      --fft-order <10..14>     STFT size as a power of two
+      --low-latency <on|off>
+      --fft-backend <name>     juce (default), simd, reference or automatic;
+                               automatic is timed per process, so its
+                               output can differ slightly between runs
+      --bits <16|24|32>        output bit depth (default 24; 32 = float)
+      --segment-threads <n>    render long files as segments on n threads
+      --segment-length <s>     segment length in seconds (default 60)
+      --pre-roll <s>           warm-up before each segment (default 10)
+      --compare <file>         report the difference from a reference
+                               render of the same input, e.g. a serial one
+      --stft-threads <n>       spread each processor's STFT over n threads
+                               (bit-identical to a serial render with
+                               the same FFT backend)
+
+    hisstory-render --batch <output-dir> <inputs…> [--threads <n>] [options]
+      Renders every input file, and every audio file directly inside each
+      input directory, to <output-dir>/<name>.wav on n threads (default:
+      one per CPU), longest files first.  Outputs are identical to single
+      renders whatever the thread count (see BatchRenderer.h).
+
+    hisstory-render --save-state <file.xml> [--state …] [--set …] …
+      Writes the state the options produce, for use with --state.
+
+    Reads anything JUCE's basic formats can (WAV, AIFF, FLAC, Ogg, MP3
+    where enabled) and writes the format named by the output's extension.
+    The output is sample-aligned with the input and the same length (see
+    OfflineRenderer.h).  No message loop or GUI initialisation is needed.
+    Exit code 0 on success, 1 on any error, 2 on bad arguments.
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+#include "BatchRenderer.h"
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+//==============================================================================
+static void printUsage()
+{
+    std::fprintf (stderr,
+        "Usage: hisstory-render <input> <output> [options]\n"
+        "       hisstory-render --batch <output-dir> <inputs...> [--threads <n>] [options]\n"
+        "       hisstory-render --save-state <file.xml> [options]\n"
+        "Options:\n"
+        "  --state <file.xml>      plugin state to start from\n"
+        "  --set <id>=<value>      parameter value in its own units (repeatable)\n"
+        "  --block <samples>       processBlock size (default 32768)\n"
+        "  --fft-order <10..14>    STFT size as a power of two\n"
+        "  --low-latency <on|off>\n"
+        "  --fft-backend <name>    juce (default), simd, reference or automatic\n"
+        "  --bits <16|24|32>       output bit depth (default 24; 32 = float)\n"
+        "  --threads <n>           batch worker threads (default: one per CPU)\n"
+        "  --segment-threads <n>   render long files as segments on n threads\n"
+        "  --segment-length <s>    segment length in seconds (default 60)\n"
+        "  --pre-roll <s>          warm-up before each segment in seconds (default 10)\n"
+        "  --compare <file>        report the difference from a reference render\n"
+        "  --stft-threads <n>      spread each processor's STFT over n threads (exact)\n");
+}
+
+static bool parseFftBackend (const juce::String& name, FftBackend::Kind& kind)
+{
+    for (const auto candidate : { FftBackend::Kind::automatic, FftBackend::Kind::juce,
+                                  FftBackend::Kind::simd, FftBackend::Kind::reference })
+    {
+        if (name.equalsIgnoreCase (FftBackend::getName (candidate)))
+        {
+            kind = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static juce::File fileFromArgument (const juce::String& path)
+{
+    return juce::File::getCurrentWorkingDirectory().getChildFile (path);
+}
+
+//==============================================================================
+//  --batch
+//==============================================================================
+static int runBatch (const OfflineRenderer::Settings& settings, int numThreads,
+                     const juce::File& outputDir, const juce::StringArray& inputs)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::vector<juce::File> inputFiles;
+
+    for (const auto& path : inputs)
+    {
+        const auto file = fileFromArgument (path);
+
+        if (file.isDirectory())
+        {
+            auto children = file.findChildFiles (juce::File::findFiles, false, formats.getWildcardForAllFormats());
+            std::sort (children.begin(), children.end(),
+                       [] (const juce::File& a, const juce::File& b) { return a.getFullPathName() < b.getFullPathName(); });
+            inputFiles.insert (inputFiles.end(), children.begin(), children.end());
+        }
+        else
+        {
+            inputFiles.push_back (file);
+        }
+    }
+
+    if (inputFiles.empty())
+    {
+        std::fprintf (stderr, "No input files\n");
+        return 2;
+    }
+
+    // Two inputs with the same name would race for one output file.
+    std::vector<BatchRenderer::Job> jobs;
+    std::map<juce::String, juce::File> outputs;
+
+    for (const auto& input : inputFiles)
+    {
+        const auto output = outputDir.getChildFile (input.getFileNameWithoutExtension() + ".wav");
+        const auto [it, inserted] = outputs.emplace (output.getFullPathName(), input);
+
+        if (! inserted)
+        {
+            std::fprintf (stderr, "%s and %s would both write %s\n", it->second.getFullPathName().toRawUTF8(),
+                          input.getFullPathName().toRawUTF8(), output.getFileName().toRawUTF8());
+            return 2;
+        }
+
+        jobs.push_back ({ input, output });
+    }
+
+    if (auto result = outputDir.createDirectory(); result.failed())
+    {
+        std::fprintf (stderr, "Cannot create %s: %s\n", outputDir.getFullPathName().toRawUTF8(),
+                      result.getErrorMessage().toRawUTF8());
+        return 1;
+    }
+
+    const BatchRenderer batch (settings, numThreads);
+    std::printf ("%d file(s) on %d thread(s) -> %s\n", static_cast<int> (jobs.size()),
+                 std::min (batch.getNumThreads(), static_cast<int> (jobs.size())),
+                 outputDir.getFullPathName().toRawUTF8());
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    const auto results = batch.render (jobs, [] (const BatchRenderer::JobResult& r, int numDone, int numJobs)
+    {
+        if (r.result.failed())
+            std::printf ("[%*d/%d] FAILED %s: %s\n", juce::String (numJobs).length(), numDone, numJobs,
+                         r.job.input.getFileName().toRawUTF8(), r.result.getErrorMessage().toRawUTF8());
+        else
+            std::printf ("[%*d/%d] %s  %.1f s audio, %.1fx real time (worker %d)\n",
+                         juce::String (numJobs).length(), numDone, numJobs, r.job.input.getFileName().toRawUTF8(),
+                         r.stats.getAudioSeconds(), r.stats.getRealTimeFactor(), r.worker);
+
+        std::fflush (stdout);
+    });
+
+    const double wallSeconds = juce::Time::highResolutionTicksToSeconds (juce::Time::getHighResolutionTicks() - startTicks);
+    double audioSeconds = 0.0;
+    int numFailed = 0;
+
+    for (const auto& r : results)
+    {
+        if (r.result.failed())
+            ++numFailed;
+        else
+            audioSeconds += r.stats.getAudioSeconds();
+    }
+
+    std::printf ("%d rendered, %d failed; %.1f s of audio in %.2f s, %.1fx real time overall\n",
+                 static_cast<int> (results.size()) - numFailed, numFailed, audioSeconds, wallSeconds,
+                 wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0);
+
+    return numFailed == 0 ? 0 : 1;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    OfflineRenderer::Settings settings;
+    juce::StringArray positional;
+    juce::File saveStateFile, batchOutputDir, compareFile;
+    int numThreads = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const juce::String arg (argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (! arg.startsWith ("--"))
+        {
+            positional.add (arg);
+            continue;
+        }
+
+        if (! hasValue)
+        {
+            std::fprintf (stderr, "Missing value for %s\n", arg.toRawUTF8());
+            printUsage();
+            return 2;
+        }
+
+        const juce::String value (argv[++i]);
+
+        if (arg == "--state")
+        {
+            settings.stateFile = fileFromArgument (value);
+        }
+        else if (arg == "--set")
+        {
+            if (! value.containsChar ('='))
+            {
+                std::fprintf (stderr, "--set expects <id>=<value>, got '%s'\n", value.toRawUTF8());
+                return 2;
+            }
+
+            settings.parameters.set (value.upToFirstOccurrenceOf ("=", false, false).trim(),
+                                     value.fromFirstOccurrenceOf ("=", false, false).trim());
+        }
+        else if (arg == "--fft-backend")
+        {
+            if (! parseFftBackend (value, settings.fftBackend))
+            {
+                std::fprintf (stderr, "--fft-backend expects juce, simd, reference or automatic, got '%s'\n",
+                              value.toRawUTF8());
+                return 2;
+            }
+        }
+        else if (arg == "--block")            settings.blockSize      = value.getIntValue();
+        else if (arg == "--fft-order")        settings.fftOrder       = value.getIntValue();
+        else if (arg == "--bits")             settings.bitsPerSample  = value.getIntValue();
+        else if (arg == "--low-latency")      settings.lowLatency     = (value == "on" || value == "1") ? 1 : 0;
+        else if (arg == "--save-state")       saveStateFile           = fileFromArgument (value);
+        else if (arg == "--batch")            batchOutputDir          = fileFromArgument (value);
+        else if (arg == "--threads")          numThreads              = value.getIntValue();
+        else if (arg == "--segment-threads")  settings.segmentThreads = value.getIntValue();
+        else if (arg == "--segment-length")   settings.segmentSeconds = value.getDoubleValue();
+        else if (arg == "--pre-roll")         settings.preRollSeconds = value.getDoubleValue();
+        else if (arg == "--compare")          compareFile             = fileFromArgument (value);
+        else if (arg == "--stft-threads")     settings.stftThreads    = value.getIntValue();
+        else
+        {
+            std::fprintf (stderr, "Unknown option %s\n", arg.toRawUTF8());
+            printUsage();
+            return 2;
+        }
+    }
+
+    const OfflineRenderer renderer (settings);
+
+    if (saveStateFile != juce::File())
+    {
+        const auto result = renderer.writeState (saveStateFile);
+
+        if (result.failed())
+        {
+            std::fprintf (stderr, "%s\n", result.getErrorMessage().toRawUTF8());
+            return 1;
+        }
+
+        std::printf ("State written to %s\n", saveStateFile.getFullPathName().toRawUTF8());
+
+        if (positional.isEmpty())
+            return 0;
+    }
+
+    if (batchOutputDir != juce::File())
+        return runBatch (settings, numThreads, batchOutputDir, positional);
+
+    if (positional.size() != 2)
+    {
+        printUsage();
+        return 2;
+    }
+
+    const auto input  = fileFromArgument (positional[0]);
+    const auto output = fileFromArgument (positional[1]);
+
+    OfflineRenderer::Stats stats;
+    const auto result = renderer.render (input, output, stats);
+
+    if (result.failed())
+    {
+        std::fprintf (stderr, "%s\n", result.getErrorMessage().toRawUTF8());
+        return 1;
+    }
+
+    std::printf ("%s -> %s\n", input.getFileName().toRawUTF8(), output.getFullPathName().toRawUTF8());
+    std::printf ("  %d ch, %.0f Hz, %.2f s; latency of %d samples flushed and trimmed\n",
+                 stats.numChannels, stats.sampleRate, stats.getAudioSeconds(), stats.latencySamples);
+
+    if (stats.numSegments > 1)
+        std::printf ("  %d segments on %d threads, %.1f s pre-roll each\n", stats.numSegments,
+                     juce::jmin (settings.segmentThreads, stats.numSegments), settings.preRollSeconds);
+
+    if (settings.stftThreads > 0)
+        std::printf ("  STFT on %d thread(s) per processor\n", settings.stftThreads);
+
+    std::printf ("  %.3f s total, %.1fx real time (processing alone %.1fx%s)\n",
+                 stats.totalSeconds, stats.getRealTimeFactor(),
+                 stats.processSeconds > 0.0 ? stats.getAudioSeconds() / stats.processSeconds : 0.0,
+                 stats.numSegments > 1 ? " per thread" : "");
+
+    if (compareFile != juce::File())
+    {
+        OfflineRenderer::Difference diff;
+
+        if (auto compared = OfflineRenderer::compare (output, compareFile, diff); compared.failed())
+        {
+            std::fprintf (stderr, "%s\n", compared.getErrorMessage().toRawUTF8());
+            return 1;
+        }
+
+        std::printf ("  vs %s: max |diff| %.3g at %.3f s, diff RMS %.1f dBFS, signal/diff %.1f dB\n",
+                     compareFile.getFileName().toRawUTF8(), diff.maxAbs, (double) diff.maxPosition / stats.sampleRate,
+                     diff.rmsDb, diff.signalToDifferenceDb);
+    }
+
+    return 0;
+}
@@ -0,0 +1,731 @@
+/*
+  ==============================================================================
+    RtCheck.cpp – real-time-safety checker for processBlock.
+
+    Interposes the allocator (malloc / calloc / realloc / free and every
+    operator new / delete), pthread mutex and rwlock locking, condition-
+    variable signals and waits, sleeps and sched_yield, file I/O (open /
+    read / write), mmap / munmap and futex waits made through syscall(),
+    then drives HisstoryAudioProcessor through the situations a host puts
+    it in.  Any of those calls made on the audio thread while a check is
+    armed is reported with a stack trace; the exit code is 1 if there was
+    at least one.
+
+    Both processBlock and parameter changes (setValueNotifyingHost, as the
+    VST3 wrapper does on the audio thread) get every check.  There are no
+    exemptions: a mutex taken only to signal a condition variable is still
+    a lock the audio thread can be made to wait on.  The one system call
+    allowed is a futex wake, which cannot block – that is how WorkerWakeup
+    wakes a parked analysis or channel worker – and it is counted as a
+    worker wake-up.
+
+    Every scenario runs its script once unchecked first, on the same
+    processor, so one-off lazy initialisation (JUCE reserving listener-list
+    storage on the first notification) does not count.
+
+    Linux / glibc only: the allocator is forwarded to __libc_malloc & co.
+    Link with -rdynamic (ENABLE_EXPORTS) for symbol names in the traces.
+
+    Scenarios:
+      1. Steady stereo, 512-sample blocks
+      2. Varying block sizes (1 to 512 samples)
+      3. Double-precision processBlock
+      4. Parameter automation every block
+      5. Bypass toggles, with and without noise tracking
+      6. Adaptive toggles
+      7. Silence gaps (silent-frame skip, new-track reset)
+      8. Display subscriber (editor open: analysis worker wake-ups)
+      9. 6 channels on 2 channel workers (worker wake-ups)
+     10. Low-latency mode at 16384 points
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+#include <atomic>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#if ! defined (__GLIBC__)
+ #error "RtCheck forwards the allocator to glibc's __libc_malloc and needs Linux / glibc"
+#endif
+
+extern "C"
+{
+    void* __libc_malloc  (size_t);
+    void* __libc_calloc  (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void  __libc_free    (void*);
+}
+
+//==============================================================================
+//  Violation tracking
+//==============================================================================
+namespace RtCheck
+{
+    enum Checks : unsigned
+    {
+        allocations = 1u << 0,
+        locks       = 1u << 1,
+        blocking    = 1u << 2,
+        everything  = allocations | locks | blocking
+    };
+
+    constexpr int maxFrames    = 32;
+    constexpr int skipFrames   = 1;     // recordViolation
+    constexpr int maxSeenTraces = 64;
+
+    /** Audio-thread state; constant-initialised, so safe to touch from the
+        allocator hooks before main(). */
+    struct ThreadState
+    {
+        unsigned    armed     = 0;
+        bool        live      = false;  // off for warm-up runs
+        bool        reporting = false;
+        bool        quiet     = false;  // count without printing (self-test)
+        const char* scenario  = "";
+        const char* phase     = "";
+    };
+
+    static thread_local ThreadState state;
+
+    static std::atomic<int> violations { 0 };
+    static std::atomic<int> wakeUps    { 0 };
+
+    static uint64_t seenTraces[maxSeenTraces] {};
+    static int      numSeenTraces = 0;
+
+    static void writeText (const char* text) noexcept
+    {
+        auto len = std::strlen (text);
+        while (len > 0)
+        {
+            const auto written = ::write (STDERR_FILENO, text, len);
+            if (written <= 0)
+                return;
+            text += written;
+            len  -= static_cast<size_t> (written);
+        }
+    }
+
+    /** Counts the violation and prints its stack the first time that stack
+        is seen.  Uses only write(2) and backtrace_symbols_fd(), neither of
+        which allocates once backtrace() has been primed. */
+    static void reportViolation (const char* kind, void* const* frames, int numFrames) noexcept
+    {
+        state.reporting = true;
+        violations.fetch_add (1);
+
+        uint64_t hash = 1469598103934665603ull;
+        for (int i = 0; i < numFrames; ++i)
+            hash = (hash ^ reinterpret_cast<uintptr_t> (frames[i])) * 1099511628211ull;
+
+        bool seen = false;
+        for (int i = 0; i < numSeenTraces && ! seen; ++i)
+            seen = seenTraces[i] == hash;
+
+        if (! seen && ! state.quiet)
+        {
+            if (numSeenTraces < maxSeenTraces)
+                seenTraces[numSeenTraces++] = hash;
+
+            char header[256];
+            std::snprintf (header, sizeof (header), "\n  RT VIOLATION: %s in %s (%s)\n",
+                           kind, state.scenario, state.phase);
+            writeText (header);
+            backtrace_symbols_fd (frames, numFrames, STDERR_FILENO);
+        }
+
+        state.reporting = false;
+    }
+
+    static void recordViolation (const char* kind) noexcept
+    {
+        void* frames[maxFrames + skipFrames];
+        const int n = backtrace (frames, maxFrames + skipFrames);
+        reportViolation (kind, frames + std::min (n, skipFrames), std::max (0, n - skipFrames));
+    }
+
+    static bool isChecking (Checks check) noexcept
+    {
+        return (state.armed & check) != 0 && ! state.reporting;
+    }
+
+    static void onEvent (Checks check, const char* kind) noexcept
+    {
+        if (! isChecking (check))
+            return;
+
+        recordViolation (kind);
+    }
+
+    static void onWakeUp() noexcept
+    {
+        if (isChecking (blocking))
+            wakeUps.fetch_add (1);
+    }
+
+    /** Arms the given checks on this thread for its lifetime (unless this
+        is a warm-up run). */
+    struct ScopedCheck
+    {
+        ScopedCheck (unsigned checks, const char* phaseName) noexcept
+            : previousArmed (state.armed), previousPhase (state.phase)
+        {
+            state.phase = phaseName;
+            state.armed = state.live ? checks : 0;
+        }
+
+        ~ScopedCheck() noexcept
+        {
+            state.armed = previousArmed;
+            state.phase = previousPhase;
+        }
+
+        const unsigned    previousArmed;
+        const char* const previousPhase;
+    };
+
+    template <typename Fn>
+    static Fn realFunction (Fn& cache, const char* name) noexcept
+    {
+        if (cache == nullptr)
+            cache = reinterpret_cast<Fn> (dlsym (RTLD_NEXT, name));
+        return cache;
+    }
+}
+
+//==============================================================================
+//  Interposed allocator
+//==============================================================================
+extern "C"
+{
+    void* malloc (size_t size)
+    {
+        RtCheck::onEvent (RtCheck::allocations, "malloc");
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t count, size_t size)
+    {
+        RtCheck::onEvent (RtCheck::allocations, "calloc");
+        return __libc_calloc (count, size);
+    }
+
+    void* realloc (void* ptr, size_t size)
+    {
+        RtCheck::onEvent (RtCheck::allocations, "realloc");
+        return __libc_realloc (ptr, size);
+    }
+
+    void free (void* ptr)
+    {
+        if (ptr != nullptr)
+            RtCheck::onEvent (RtCheck::allocations, "free");
+        __libc_free (ptr);
+    }
+}
+
+static void* checkedNew (size_t size, const char* kind)
+{
+    RtCheck::onEvent (RtCheck::allocations, kind);
+
+    if (auto* p = __libc_malloc (size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+static void* checkedAlignedNew (size_t size, std::align_val_t alignment, const char* kind)
+{
+    RtCheck::onEvent (RtCheck::allocations, kind);
+
+    const auto align = std::max (sizeof (void*), static_cast<size_t> (alignment));
+    void* p = nullptr;
+    if (posix_memalign (&p, align, size == 0 ? 1 : size) != 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+static void checkedDelete (void* p) noexcept
+{
+    if (p != nullptr)
+        RtCheck::onEvent (RtCheck::allocations, "operator delete");
+    __libc_free (p);
+}
+
+void* operator new   (size_t size)                                     { return checkedNew (size, "operator new"); }
+void* operator new[] (size_t size)                                     { return checkedNew (size, "operator new[]"); }
+void* operator new   (size_t size, std::align_val_t a)                 { return checkedAlignedNew (size, a, "operator new"); }
+void* operator new[] (size_t size, std::align_val_t a)                 { return checkedAlignedNew (size, a, "operator new[]"); }
+void* operator new   (size_t size, const std::nothrow_t&) noexcept     { try { return checkedNew (size, "operator new"); }   catch (...) { return nullptr; } }
+void* operator new[] (size_t size, const std::nothrow_t&) noexcept     { try { return checkedNew (size, "operator new[]"); } catch (...) { return nullptr; } }
+
+void operator delete   (void* p) noexcept                              { checkedDelete (p); }
+void operator delete[] (void* p) noexcept                              { checkedDelete (p); }
+void operator delete   (void* p, size_t) noexcept                      { checkedDelete (p); }
+void operator delete[] (void* p, size_t) noexcept                      { checkedDelete (p); }
+void operator delete   (void* p, std::align_val_t) noexcept            { checkedDelete (p); }
+void operator delete[] (void* p, std::align_val_t) noexcept            { checkedDelete (p); }
+void operator delete   (void* p, size_t, std::align_val_t) noexcept    { checkedDelete (p); }
+void operator delete[] (void* p, size_t, std::align_val_t) noexcept    { checkedDelete (p); }
+void operator delete   (void* p, const std::nothrow_t&) noexcept       { checkedDelete (p); }
+void operator delete[] (void* p, const std::nothrow_t&) noexcept       { checkedDelete (p); }
+
+//==============================================================================
+//  Interposed locks, waits and sleeps (forwarded through RTLD_NEXT)
+//==============================================================================
+extern "C"
+{
+    int pthread_mutex_lock (pthread_mutex_t* m)
+    {
+        static int (*real) (pthread_mutex_t*) = nullptr;
+        RtCheck::onEvent (RtCheck::locks, "mutex lock");
+        return RtCheck::realFunction (real, "pthread_mutex_lock") (m);
+    }
+
+    int pthread_mutex_trylock (pthread_mutex_t* m)
+    {
+        static int (*real) (pthread_mutex_t*) = nullptr;
+        RtCheck::onEvent (RtCheck::locks, "mutex try-lock");
+        return RtCheck::realFunction (real, "pthread_mutex_trylock") (m);
+    }
+
+    int pthread_rwlock_rdlock (pthread_rwlock_t* l)
+    {
+        static int (*real) (pthread_rwlock_t*) = nullptr;
+        RtCheck::onEvent (RtCheck::locks, "rwlock read lock");
+        return RtCheck::realFunction (real, "pthread_rwlock_rdlock") (l);
+    }
+
+    int pthread_rwlock_wrlock (pthread_rwlock_t* l)
+    {
+        static int (*real) (pthread_rwlock_t*) = nullptr;
+        RtCheck::onEvent (RtCheck::locks, "rwlock write lock");
+        return RtCheck::realFunction (real, "pthread_rwlock_wrlock") (l);
+    }
+
+    int pthread_cond_signal (pthread_cond_t* c)
+    {
+        static int (*real) (pthread_cond_t*) = nullptr;
+        RtCheck::onEvent (RtCheck::locks, "condition signal");
+        return RtCheck::realFunction (real, "pthread_cond_signal") (c);
+    }
+
+    int pthread_cond_broadcast (pthread_cond_t* c)
+    {
+        static int (*real) (pthread_cond_t*) = nullptr;
+        RtCheck::onEvent (RtCheck::locks, "condition broadcast");
+        return RtCheck::realFunction (real, "pthread_cond_broadcast") (c);
+    }
+
+    int pthread_cond_wait (pthread_cond_t* c, pthread_mutex_t* m)
+    {
+        static int (*real) (pthread_cond_t*, pthread_mutex_t*) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "condition wait");
+        return RtCheck::realFunction (real, "pthread_cond_wait") (c, m);
+    }
+
+    int pthread_cond_timedwait (pthread_cond_t* c, pthread_mutex_t* m, const struct timespec* t)
+    {
+        static int (*real) (pthread_cond_t*, pthread_mutex_t*, const struct timespec*) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "condition timed wait");
+        return RtCheck::realFunction (real, "pthread_cond_timedwait") (c, m, t);
+    }
+
+    int nanosleep (const struct timespec* request, struct timespec* remaining)
+    {
+        static int (*real) (const struct timespec*, struct timespec*) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "nanosleep");
+        return RtCheck::realFunction (real, "nanosleep") (request, remaining);
+    }
+
+    int clock_nanosleep (clockid_t clock, int flags, const struct timespec* request, struct timespec* remaining)
+    {
+        static int (*real) (clockid_t, int, const struct timespec*, struct timespec*) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "clock_nanosleep");
+        return RtCheck::realFunction (real, "clock_nanosleep") (clock, flags, request, remaining);
+    }
+
+    int usleep (useconds_t micros)
+    {
+        static int (*real) (useconds_t) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "usleep");
+        return RtCheck::realFunction (real, "usleep") (micros);
+    }
+
+    int sched_yield()
+    {
+        static int (*real)() = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "sched_yield");
+        return RtCheck::realFunction (real, "sched_yield")();
+    }
+}
+
+//==============================================================================
+//  Interposed file I/O, memory mapping and raw system calls
+//==============================================================================
+extern "C"
+{
+    // reportViolation() writes its report through these with `reporting`
+    // set, so they do not report themselves.
+    ssize_t write (int fd, const void* data, size_t size)
+    {
+        static ssize_t (*real) (int, const void*, size_t) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "write");
+        return RtCheck::realFunction (real, "write") (fd, data, size);
+    }
+
+    ssize_t read (int fd, void* data, size_t size)
+    {
+        static ssize_t (*real) (int, void*, size_t) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "read");
+        return RtCheck::realFunction (real, "read") (fd, data, size);
+    }
+
+    int open (const char* path, int flags, ...)
+    {
+        static int (*real) (const char*, int, ...) = nullptr;
+        va_list args;
+        va_start (args, flags);
+        const auto mode = static_cast<mode_t> (va_arg (args, unsigned));
+        va_end (args);
+        RtCheck::onEvent (RtCheck::blocking, "open");
+        return RtCheck::realFunction (real, "open") (path, flags, mode);
+    }
+
+    int openat (int dirFd, const char* path, int flags, ...)
+    {
+        static int (*real) (int, const char*, int, ...) = nullptr;
+        va_list args;
+        va_start (args, flags);
+        const auto mode = static_cast<mode_t> (va_arg (args, unsigned));
+        va_end (args);
+        RtCheck::onEvent (RtCheck::blocking, "openat");
+        return RtCheck::realFunction (real, "openat") (dirFd, path, flags, mode);
+    }
+
+    void* mmap (void* address, size_t length, int protection, int flags, int fd, off_t offset)
+    {
+        static void* (*real) (void*, size_t, int, int, int, off_t) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "mmap");
+        return RtCheck::realFunction (real, "mmap") (address, length, protection, flags, fd, offset);
+    }
+
+    int munmap (void* address, size_t length)
+    {
+        static int (*real) (void*, size_t) = nullptr;
+        RtCheck::onEvent (RtCheck::blocking, "munmap");
+        return RtCheck::realFunction (real, "munmap") (address, length);
+    }
+
+    /** Futex waits (WorkerWakeup::wait, or anything else parking through
+        syscall()) are violations; futex wakes are counted as worker
+        wake-ups; any other raw system call is a violation. */
+    long syscall (long number, ...)
+    {
+        static long (*real) (long, ...) = nullptr;
+        va_list args;
+        va_start (args, number);
+        long a[6];
+        for (auto& arg : a)
+            arg = va_arg (args, long);
+        va_end (args);
+
+        if (number == SYS_futex)
+        {
+            const auto command = static_cast<int> (a[1]) & FUTEX_CMD_MASK;
+
+            if (command == FUTEX_WAKE || command == FUTEX_WAKE_BITSET || command == FUTEX_WAKE_OP)
+                RtCheck::onWakeUp();
+            else
+                RtCheck::onEvent (RtCheck::blocking, "futex wait");
+        }
+        else
+        {
+            RtCheck::onEvent (RtCheck::blocking, "system call");
+        }
+
+        return RtCheck::realFunction (real, "syscall") (number, a[0], a[1], a[2], a[3], a[4], a[5]);
+    }
+}
+
+//==============================================================================
+//  Driver
+//==============================================================================
+namespace
+{
+    constexpr double sampleRate   = 44100.0;
+    constexpr int    maxBlockSize = 512;
+
+    /** A processor plus preallocated blocks; only process() and
+        setParameter() run checked. */
+    struct Session
+    {
+        Session (int numChannels, int fftOrder = HisstoryAudioProcessor::defaultFftOrder,
+                 bool lowLatency = false, int workerThreads = 0, bool doublePrecision = false)
+            : proc (fftOrder), channels (numChannels),
+              block (numChannels, maxBlockSize), blockDouble (numChannels, maxBlockSize)
+        {
+            proc.setProcessingPrecision (doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                         : juce::AudioProcessor::singlePrecision);
+            proc.setLowLatencyMode (lowLatency);
+            proc.setChannelWorkerThreads (workerThreads);
+            proc.setPlayConfigDetails (numChannels, numChannels, sampleRate, maxBlockSize);
+            proc.prepareToPlay (sampleRate, maxBlockSize);
+        }
+
+        ~Session() { proc.releaseResources(); }
+
+        /** Sine + hiss at `level`, or digital silence for level 0. */
+        void process (int numSamples, float level, bool doublePrecision = false)
+        {
+            for (int ch = 0; ch < channels; ++ch)
+            {
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    const auto t = static_cast<double> (position + i) / sampleRate;
+                    rng = rng * 1664525u + 1013904223u;
+                    const float hiss = (static_cast<float> (rng >> 8) / 8388608.0f - 1.0f) * 0.05f;
+                    const float x    = level * (0.5f * (float) std::sin (2.0 * juce::MathConstants<double>::pi
+                                                                         * (330.0 + 110.0 * ch) * t) + hiss);
+                    block.setSample (ch, i, x);
+                    blockDouble.setSample (ch, i, x);
+                }
+            }
+
+            position += numSamples;
+
+            if (doublePrecision)
+            {
+                juce::AudioBuffer<double> view (blockDouble.getArrayOfWritePointers(), channels, numSamples);
+                RtCheck::ScopedCheck check (RtCheck::everything, "processBlock");
+                proc.processBlock (view, midi);
+            }
+            else
+            {
+                juce::AudioBuffer<float> view (block.getArrayOfWritePointers(), channels, numSamples);
+                RtCheck::ScopedCheck check (RtCheck::everything, "processBlock");
+                proc.processBlock (view, midi);
+            }
+        }
+
+        void processSeconds (double seconds, float level, int blockSize = maxBlockSize)
+        {
+            for (int n = static_cast<int> (seconds * sampleRate); n > 0; n -= blockSize)
+                process (std::min (n, blockSize), level);
+        }
+
+        void setParameter (const char* id, float value01)
+        {
+            auto* param = proc.apvts.getParameter (id);
+            RtCheck::ScopedCheck check (RtCheck::everything, "parameter change");
+            param->setValueNotifyingHost (value01);
+        }
+
+        HisstoryAudioProcessor     proc;
+        const int                  channels;
+        juce::AudioBuffer<float>   block;
+        juce::AudioBuffer<double>  blockDouble;
+        juce::MidiBuffer           midi;
+        int64_t                    position = 0;
+        uint32_t                   rng      = 1;
+    };
+
+    struct Scenario
+    {
+        const char* name;
+        std::unique_ptr<Session> (*create)();
+        void (*script) (Session&);
+    };
+
+    std::unique_ptr<Session> stereo() { return std::make_unique<Session> (2); }
+
+    const Scenario scenarios[]
+    {
+        { "steady stereo", stereo,
+          [] (Session& s) { s.processSeconds (2.0, 1.0f); } },
+
+        { "varying block sizes", stereo,
+          [] (Session& s)
+          {
+              for (int rep = 0; rep < 40; ++rep)
+                  for (int size : { 1, 7, 64, 100, 128, 333, 511, 512 })
+                      s.process (size, 1.0f);
+          } },
+
+        { "double precision",
+          [] { return std::make_unique<Session> (2, HisstoryAudioProcessor::defaultFftOrder, false, 0, true); },
+          [] (Session& s)
+          {
+              for (int b = 0; b < 200; ++b)
+                  s.process (maxBlockSize, 1.0f, true);
+          } },
+
+        { "parameter automation", stereo,
+          [] (Session& s)
+          {
+              const char* ids[] { "threshold", "reduction", "smoothing", "band1", "band3", "band6" };
+              for (int b = 0; b < 200; ++b)
+              {
+                  s.setParameter (ids[b % 6], 0.5f + 0.4f * std::sin (0.05f * (float) b));
+                  s.process (maxBlockSize, 1.0f);
+              }
+          } },
+
+        { "bypass toggles", stereo,
+          [] (Session& s)
+          {
+              for (const bool track : { true, false })
+              {
+                  s.proc.setTrackNoiseWhileBypassed (track);
+                  for (int cycle = 0; cycle < 4; ++cycle)
+                  {
+                      s.setParameter ("bypass", 1.0f);
+                      s.processSeconds (0.3, 1.0f);
+                      s.setParameter ("bypass", 0.0f);
+                      s.processSeconds (0.3, 1.0f);
+                  }
+              }
+          } },
+
+        { "adaptive toggles", stereo,
+          [] (Session& s)
+          {
+              for (int cycle = 0; cycle < 4; ++cycle)
+              {
+                  s.setParameter ("adaptive", 0.0f);
+                  s.processSeconds (0.25, 1.0f);
+                  s.setParameter ("adaptive", 1.0f);
+                  s.processSeconds (0.25, 1.0f);
+              }
+          } },
+
+        { "silence gaps", stereo,
+          [] (Session& s)
+          {
+              for (int cycle = 0; cycle < 2; ++cycle)
+              {
+                  s.processSeconds (1.0, 1.0f);
+                  s.processSeconds (0.8, 0.0f);      // > 0.5 s gap: new-track reset
+                  s.processSeconds (0.2, 1.0e-7f);   // below the silent-frame floor
+              }
+          } },
+
+        { "display subscriber", stereo,
+          [] (Session& s)
+          {
+              s.proc.addDisplaySubscriber();
+              s.processSeconds (2.0, 1.0f, 128);
+              s.proc.waitForDisplayAnalysis();
+              s.proc.removeDisplaySubscriber();
+          } },
+
+        { "6 channels, 2 workers",
+          [] { return std::make_unique<Session> (6, HisstoryAudioProcessor::defaultFftOrder, false, 2); },
+          [] (Session& s) { s.processSeconds (2.0, 1.0f); } },
+
+        { "low latency, 16384 points",
+          [] { return std::make_unique<Session> (2, HisstoryAudioProcessor::maxFftOrder, true); },
+          [] (Session& s) { s.processSeconds (1.0, 1.0f, 256); } },
+    };
+
+    /** The hooks must be live, or every scenario would pass vacuously. */
+    bool selfTest()
+    {
+        RtCheck::state.scenario = "self-test";
+        RtCheck::state.live     = true;
+        RtCheck::state.quiet    = true;
+        int* volatile p = nullptr;
+        {
+            RtCheck::ScopedCheck check (RtCheck::allocations, "expected violation");
+            p = new int (1);
+        }
+        const bool allocationCaught = RtCheck::violations.exchange (0) == 1;
+        delete p;
+
+        pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+        pthread_cond_t  cond  = PTHREAD_COND_INITIALIZER;
+        {
+            RtCheck::ScopedCheck check (RtCheck::everything, "expected violation");
+            pthread_mutex_lock (&mutex);            // lock and signal: two violations
+            pthread_cond_signal (&cond);
+            pthread_mutex_unlock (&mutex);
+        }
+        const bool lockCaught = RtCheck::violations.exchange (0) == 2;
+
+        uint32_t futexWord = 0;
+        {
+            RtCheck::ScopedCheck check (RtCheck::everything, "expected violation");
+            const timespec noWait { 0, 0 };
+            syscall (SYS_futex, &futexWord, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);      // a wake-up
+            syscall (SYS_futex, &futexWord, FUTEX_WAIT_PRIVATE, 1, &noWait, nullptr, 0);      // a violation
+            sched_yield();                                                                     // a violation
+        }
+        const bool syscallsCaught = RtCheck::violations.exchange (0) == 2 && RtCheck::wakeUps.exchange (0) == 1;
+
+        RtCheck::state.live  = false;
+        RtCheck::state.quiet = false;
+
+        return allocationCaught && lockCaught && syscallsCaught;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    // backtrace() loads libgcc on first use, which allocates.
+    void* primer[4];
+    backtrace (primer, 4);
+
+    std::printf ("======================================================\n");
+    std::printf ("  Real-time safety: allocations, locks, blocking calls\n");
+    std::printf ("======================================================\n");
+
+    if (! selfTest())
+    {
+        std::printf ("  Self-test FAILED: the interposed hooks are not being called\n");
+        return 1;
+    }
+
+    bool allPass = true;
+
+    for (const auto& scenario : scenarios)
+    {
+        RtCheck::state.scenario = scenario.name;
+
+        auto session = scenario.create();
+        RtCheck::state.live = false;
+        scenario.script (*session);
+
+        RtCheck::violations = 0;
+        RtCheck::wakeUps    = 0;
+        RtCheck::state.live = true;
+        scenario.script (*session);
+        RtCheck::state.live = false;
+
+        const int found = RtCheck::violations.load();
+        allPass = allPass && found == 0;
+
+        std::printf ("  %-28s %s  (%d violations, %d worker wake-ups)\n", scenario.name,
+                     found == 0 ? "PASS" : "FAIL", found, RtCheck::wakeUps.load());
+        std::fflush (stdout);
+    }
+
+    std::printf ("Overall: %s\n", allPass ? "REAL-TIME SAFE" : "VIOLATIONS FOUND");
+    return allPass ? 0 : 1;
+}
@@ -0,0 +1,1788 @@
+/*
+  ==============================================================================
+    Hisstory – SpectralEngine.cpp
+
+    STFT framing, transforms and the per-bin spectral gate, instantiated for
+    every supported FFT order.
+  ==============================================================================
+*/
+
+#include "SpectralEngine.h"
+#include "SpectralKernels.h"
+#include "AnalysisWorker.h"
+
+//==============================================================================
+//  Output stage helpers
+//==============================================================================
+namespace
+{
+    /** sin (x·π/2) sampled at equalPowerTableSize + 1 points over [0, 1]; the
+        dry gain of an equal-power crossfade is the same curve read at 1 − x.
+        Linear interpolation keeps the summed power within 1e-6 of unity. */
+    constexpr int equalPowerTableSize = 1024;
+
+    const std::array<float, equalPowerTableSize + 1> equalPowerTable = []
+    {
+        std::array<float, equalPowerTableSize + 1> table {};
+
+        for (int i = 0; i <= equalPowerTableSize; ++i)
+            table[static_cast<size_t> (i)] = static_cast<float> (std::sin (juce::MathConstants<double>::halfPi
+                                                                           * i / equalPowerTableSize));
+
+        // Exact end points, so a finished ramp is exactly wet or exactly dry.
+        table.front() = 0.0f;
+        table.back()  = 1.0f;
+        return table;
+    }();
+
+    /** Equal-power gain for a mix position in [0, 1]. */
+    inline float equalPowerGain (float x) noexcept
+    {
+        const float pos  = x * static_cast<float> (equalPowerTableSize);
+        const int   idx  = std::min (static_cast<int> (pos), equalPowerTableSize - 1);
+        const float frac = pos - static_cast<float> (idx);
+        const float a    = equalPowerTable[static_cast<size_t> (idx)];
+        const float b    = equalPowerTable[static_cast<size_t> (idx + 1)];
+        return a + frac * (b - a);
+    }
+
+    /** Scalar form of HisstoryKernels::clampAndMix()'s safety clamp, for
+        the bypass ramp and the double-precision path. */
+    template <typename SampleType>
+    inline SampleType clampToDry (SampleType wet, SampleType dry) noexcept
+    {
+        const SampleType absOut = std::abs (wet);
+        const SampleType absIn  = std::abs (dry);
+
+        if (absOut > absIn * SampleType (4))
+            return absIn > SampleType (1e-8) ? wet * (absIn / absOut) : SampleType (0);
+
+        return wet;
+    }
+
+    /** Sum of squares of an output span. */
+    inline float sumOfSquares (const float* x, int n) noexcept
+    {
+        return HisstoryKernels::sumOfSquares (x, n);
+    }
+
+    inline float sumOfSquares (const double* x, int n) noexcept
+    {
+        double energy = 0.0;
+        for (int i = 0; i < n; ++i)
+            energy += x[i] * x[i];
+
+        return static_cast<float> (energy);
+    }
+
+    /** Clamps and mixes a span at a fixed wet/dry position.  io holds the
+        delayed input on entry and the output on return; fully dry leaves it
+        untouched.  Returns the output's sum of squares. */
+    template <typename SampleType>
+    float mixAtConstantGain (SampleType* io, const float* accum, int n, float wetMix) noexcept
+    {
+        if (n <= 0)
+            return 0.0f;
+
+        if (wetMix <= 0.0f)
+            return sumOfSquares (io, n);
+
+        const float wetGain = equalPowerGain (wetMix);
+        const float dryGain = equalPowerGain (1.0f - wetMix);
+
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            return HisstoryKernels::clampAndMix (io, accum, n, dryGain, wetGain);
+        }
+        else
+        {
+            double energy = 0.0;
+
+            for (int i = 0; i < n; ++i)
+            {
+                io[i] = io[i] * dryGain + clampToDry<SampleType> (accum[i], io[i]) * wetGain;
+                energy += io[i] * io[i];
+            }
+
+            return static_cast<float> (energy);
+        }
+    }
+}
+
+//==============================================================================
+//  Engine factory
+//==============================================================================
+std::unique_ptr<HisstoryAudioProcessor::EngineBase>
+HisstoryAudioProcessor::createEngine (HisstoryAudioProcessor& processor, int fftOrder, bool lowLatency)
+{
+    if (lowLatency)
+    {
+        switch (juce::jlimit (minFftOrder, maxFftOrder, fftOrder))
+        {
+            case 10:  return std::make_unique<Engine<10, true>> (processor);
+            case 11:  return std::make_unique<Engine<11, true>> (processor);
+            case 13:  return std::make_unique<Engine<13, true>> (processor);
+            case 14:  return std::make_unique<Engine<14, true>> (processor);
+            default:  return std::make_unique<Engine<12, true>> (processor);
+        }
+    }
+
+    switch (juce::jlimit (minFftOrder, maxFftOrder, fftOrder))
+    {
+        case 10:  return std::make_unique<Engine<10, false>> (processor);
+        case 11:  return std::make_unique<Engine<11, false>> (processor);
+        case 13:  return std::make_unique<Engine<13, false>> (processor);
+        case 14:  return std::make_unique<Engine<14, false>> (processor);
+        default:  return std::make_unique<Engine<12, false>> (processor);
+    }
+}
+
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::Engine (HisstoryAudioProcessor& processor)
+    : owner (processor)
+{
+    buildWindows();
+}
+
+//==============================================================================
+//  Analysis / synthesis windows
+//  Low latency, with N = fftSize, M = hopSize and periodic Hann H_L(n):
+//      analysis  = √H_2(N−M) rising over [0, N−M), √H_2M falling over [N−M, N)
+//      synthesis = 0 before N−2M, H_2M / analysis over [N−2M, N−M),
+//                  √H_2M falling over [N−M, N)
+//  so analysis × synthesis is H_2M on the last 2M samples, which overlap-adds
+//  to exactly 1 at hop M.  The analysis window is scaled to the energy of
+//  the standard Hann (and the synthesis window by the inverse), so bin
+//  magnitudes – and therefore thresholds and noise profiles – read the same
+//  in both modes.
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::buildWindows()
+{
+    using Window = juce::dsp::WindowingFunction<float>;
+
+    if constexpr (! lowLatency)
+    {
+        // normalise = false: standard Hann (peak = 1.0, COLA = 1.5 for Hann²)
+        Window::fillWindowingTables (analysisWindow.data(), static_cast<size_t> (fftSize),
+                                     Window::hann, false);
+        synthesisWindow = analysisWindow;
+    }
+    else
+    {
+        constexpr int longHalf  = fftSize - hopSize;      // N − M
+        constexpr int shortSpan = synthesisLength;        // 2M
+
+        auto hann = [] (int n, int length)
+        {
+            return 0.5 - 0.5 * std::cos (2.0 * juce::MathConstants<double>::pi
+                                         * static_cast<double> (n) / static_cast<double> (length));
+        };
+
+        double hannEnergy = 0.0, analysisEnergy = 0.0;
+        std::vector<double> analysis (fftSize, 0.0), synthesis (fftSize, 0.0);
+
+        for (int n = 0; n < fftSize; ++n)
+        {
+            analysis[n] = (n < longHalf) ? std::sqrt (hann (n, 2 * longHalf))
+                                         : std::sqrt (hann (n - synthesisStart, shortSpan));
+
+            if (n >= longHalf)
+                synthesis[n] = analysis[n];
+            else if (n >= synthesisStart)
+                synthesis[n] = hann (n - synthesisStart, shortSpan) / analysis[n];
+
+            const double h = hann (n, fftSize - 1);       // same table as the standard mode
+            hannEnergy     += h * h;
+            analysisEnergy += analysis[n] * analysis[n];
+        }
+
+        const double scale = std::sqrt (hannEnergy / analysisEnergy);
+
+        for (int n = 0; n < fftSize; ++n)
+        {
+            analysisWindow[n]  = static_cast<float> (analysis[n] * scale);
+            synthesisWindow[n] = static_cast<float> (synthesis[n] / scale);
+        }
+    }
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::ChannelState::reset()
+{
+    inputFifo.fill (0.0f);
+    outputAccum.fill (0.0f);
+    fifoWritePos    = 0;
+    outputReadPos   = 0;
+    samplesUntilHop = hopSize;
+    prevGain.fill (1.0f);
+    signalLevel     = 0.0f;
+    frameDue        = false;
+    frameSilent     = false;
+    frameUnityGain  = false;
+    hopEnergies.fill (0.0f);
+    hopEnergy       = 0.0f;
+    hopEnergyPos    = 0;
+}
+
+//==============================================================================
+//  Prepare
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::prepare (int numChannels)
+{
+    channels.resize (static_cast<size_t> (numChannels));
+    frameUnits.resize (static_cast<size_t> (numChannels));
+    numFrameUnits = 0;
+
+    const bool doublePrecision = owner.isUsingDoublePrecision();
+
+    // Automatic selection benchmarks the backends once per order and process.
+    const auto requested = owner.requestedFftBackend.load();
+    fftBackend = requested == FftBackend::Kind::automatic ? FftBackend::selectFastest (fftOrder) : requested;
+
+    for (auto& ch : channels)
+    {
+        if (ch.fft == nullptr || ch.fft->getKind() != fftBackend)
+            ch.fft = FftBackend::create (fftOrder, fftBackend);
+
+        ch.reset();
+        ch.dryDelay.assign (doublePrecision ? static_cast<size_t> (fftSize) : 0, 0.0);
+    }
+
+    runningMean.fill (0.0f);
+    runningMeanSq.fill (0.0f);
+
+    snapshotIntervalSamples = juce::roundToInt (owner.currentSampleRate.load() / displayRefreshHz);
+    samplesUntilSnapshot    = 0;
+
+    wetPathIdle        = false;
+    wetWarmUpRemaining = 0;
+    hopsSinceTracked   = 0;
+
+    // ── Offline three-phase STFT: pass storage and one FFT per lane ──────────
+    const int numLanes = owner.offlineStftThreads;
+    const auto numSlots = static_cast<size_t> (numLanes > 0 ? offlineFramesPerPass * numChannels : 0);
+
+    offlineLanes.resize (static_cast<size_t> (numLanes));
+
+    for (auto& lane : offlineLanes)
+        if (lane.fft == nullptr || lane.fft->getKind() != fftBackend)
+            lane.fft = FftBackend::create (fftOrder, fftBackend);
+
+    offlineSpans.resize (numLanes > 0 ? static_cast<size_t> (offlineFramesPerPass + 1) : 0);
+    offlineFrameOffsets.resize (numLanes > 0 ? static_cast<size_t> (offlineFramesPerPass) : 0);
+    offlineSlots.resize (numSlots);
+    offlineUnits.resize (numSlots);
+    offlineHistory.assign (numLanes > 0 ? static_cast<size_t> (offlineHistoryLength * numChannels) : 0, 0.0f);
+    offlineSpectra.assign (numSlots * static_cast<size_t> (fftSize * 2), 0.0f);
+    offlineEnergy.resize (static_cast<size_t> (numLanes > 0 ? (offlineFramesPerPass + 1) * numChannels : 0));
+    offlineChannelTicks.resize (static_cast<size_t> (numLanes > 0 ? numChannels : 0));
+
+    updateWindowCorrection();
+    rebuildBinCoefficients();
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::updateWindowCorrection()
+{
+    // Every backend declares its round-trip gain (1 if the inverse divides
+    // by N, otherwise N), and it is the same for the real transform and the
+    // paired complex one.  For Hann² (analysis + synthesis window) with 75 %
+    // overlap the COLA sum is exactly 1.5 (1.0 for the low-latency pair).
+    // Full correction = 1 / (roundTrip * colaSum).
+    owner.windowCorrection = 1.0f / (channels.front().fft->getRoundTripGain() * colaSum);
+}
+
+//==============================================================================
+//  Default noise profile – hiss-shaped so the plugin works before Learn
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::generateDefaultNoiseProfile()
+{
+    const float sr = owner.currentSampleRate.load();
+
+    // The shape below is tuned for displayFftSize.  Noise magnitude grows
+    // with √N in an unnormalised FFT, so other sizes are scaled to match.
+    const float sizeScale = std::sqrt (static_cast<float> (fftSize) / static_cast<float> (displayFftSize));
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        float freq = static_cast<float> (bin) * sr / static_cast<float> (fftSize);
+
+        // Model hiss as a gentle upward slope above 1 kHz (~3 dB/octave).
+        // Use a low base magnitude so the threshold curve starts near the
+        // bottom of the display in non-adaptive mode (user drags up to gate).
+        float baseMag = 0.5f;
+
+        if (freq > 1000.0f)
+        {
+            float octaves = std::log2 (freq / 1000.0f);
+            baseMag *= std::pow (1.41f, octaves);   // +3 dB per octave
+        }
+        else
+        {
+            float rolloff = freq / 1000.0f;
+            baseMag *= std::max (rolloff, 0.1f);
+        }
+
+        noiseProfile[bin] = baseMag * sizeScale;
+    }
+
+    pushNoiseProfile (0);
+}
+
+//==============================================================================
+//  Reset adaptive profile – start from near-zero (no removal)
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::resetAdaptiveProfile()
+{
+    for (int bin = 0; bin < numBins; ++bin)
+        noiseProfile[bin] = 1e-7f;
+
+    pushNoiseProfile (AnalysisWorker::resetMetrics);
+
+    runningMean.fill (0.0f);
+    runningMeanSq.fill (0.0f);
+
+    for (auto& ch : channels)
+        ch.prevGain.fill (1.0f);
+}
+
+//==============================================================================
+//  Display-frame decimation
+//  The countdown runs whether or not anyone is watching, so an editor that
+//  opens picks up on the next due frame.  The carry keeps the average rate
+//  at displayRefreshHz when hops are shorter than the interval; longer hops
+//  simply publish every frame.
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+bool HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::isDisplayFrame() noexcept
+{
+    samplesUntilSnapshot -= hopSize;
+
+    if (samplesUntilSnapshot > 0)
+        return false;
+
+    samplesUntilSnapshot = std::max (samplesUntilSnapshot + snapshotIntervalSamples, 0);
+    return owner.displaySubscribers.load (std::memory_order_relaxed) > 0;
+}
+
+//==============================================================================
+//  Editor feed: one record per display frame (or profile change) to the
+//  analysis worker.  A full FIFO drops the record rather than waiting.
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::pushDisplayFrame (const ChannelState& ch)
+{
+    const uint32_t flags = AnalysisWorker::hasSpectrum
+                         | (owner.pBypass->load() > 0.5f ? AnalysisWorker::bypassed : 0u);
+
+    owner.analysisWorker->push (scratch.mags.data(), ch.prevGain.data(), scratch.stationarity.data(),
+                                noiseProfile.data(), flags);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::pushNoiseProfile (uint32_t flags)
+{
+    owner.analysisWorker->push (nullptr, nullptr, nullptr, noiseProfile.data(), flags);
+}
+
+//==============================================================================
+//  Per-bin coefficient tables
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::rebuildBinCoefficients()
+{
+    const float sr    = owner.currentSampleRate.load();
+    const float binHz = sr / static_cast<float> (fftSize);
+
+    const float logFirst = std::log2 (bandFrequencies.front());
+    const float logLast  = std::log2 (bandFrequencies.back());
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        // ── Band interpolation (same arithmetic as interpolateBandOffset) ────
+        const float freq    = static_cast<float> (bin) * sr / static_cast<float> (fftSize);
+        const float logFreq = std::log2 (std::max (freq, 1.0f));
+
+        int   band   = 0;
+        float weight = 0.0f;
+
+        if (logFreq >= logLast)
+        {
+            band = numBands - 1;   // weight 0 → exactly the last offset
+        }
+        else if (logFreq > logFirst)
+        {
+            for (int i = 0; i < numBands - 1; ++i)
+            {
+                const float logLow  = std::log2 (bandFrequencies[i]);
+                const float logHigh = std::log2 (bandFrequencies[i + 1]);
+
+                if (logFreq <= logHigh)
+                {
+                    band   = i;
+                    weight = (logFreq - logLow) / (logHigh - logLow);
+                    break;
+                }
+            }
+        }
+
+        binCoefficients.frequency[bin]    = freq;
+        binCoefficients.logFrequency[bin] = logFreq;
+        binCoefficients.bandIndex[bin]    = band;
+        binCoefficients.bandWeight[bin]   = weight;
+
+        // ── Frequency-dependent noise bias ───────────────────────────────────
+        //   Below 2 kHz: 1.1 (conservative, preserve signal)
+        //   2–4 kHz: ramp 1.1 → 1.8
+        //   Above 4 kHz: 1.8 (target hiss)
+        const float biasFreq = static_cast<float> (bin) * binHz;
+
+        if (biasFreq < 2000.0f)
+            binCoefficients.noiseBias[bin] = 1.1f;
+        else if (biasFreq < 4000.0f)
+            binCoefficients.noiseBias[bin] = 1.1f + 0.7f * ((biasFreq - 2000.0f) / 2000.0f);
+        else
+            binCoefficients.noiseBias[bin] = 1.8f;
+    }
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::updatePerBinThreshold()
+{
+    const float globalThrDB = owner.pThreshold->load();
+    const bool  isAdaptive  = owner.pAdaptive->load() > 0.5f;
+
+    // One extra entry so the top band can be addressed with weight 0.
+    std::array<float, numBands + 1> offsets;
+    for (int i = 0; i < numBands; ++i)
+        offsets[i] = owner.pBand[i]->load();
+    offsets[numBands] = offsets[numBands - 1];
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const int   i = binCoefficients.bandIndex[bin];
+        const float t = binCoefficients.bandWeight[bin];
+        float bandOff = offsets[i] + t * (offsets[i + 1] - offsets[i]);
+
+        // In adaptive mode, shift band offsets upward so the default
+        // low values still provide effective gating once the profile
+        // has converged.
+        if (isAdaptive)
+            bandOff += adaptiveBandBoost;
+
+        float totalDB = globalThrDB + bandOff;
+        perBinThreshold[bin] = juce::Decibels::decibelsToGain (totalDB);
+    }
+}
+
+//==============================================================================
+//  Block processing
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::process (juce::AudioBuffer<float>& buffer,
+                                                                     int numCh)
+{
+    if (! canProcessOffline (numCh))
+    {
+        processSamples (buffer, numCh);
+        return;
+    }
+
+    const bool pairChannels = owner.usePairedStereoFFT.load (std::memory_order_relaxed);
+
+    blockOutputEnergy = 0.0f;
+
+    for (int start = 0; start < buffer.getNumSamples();)
+        start = processOfflinePass (buffer, start, numCh, pairChannels);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::process (juce::AudioBuffer<double>& buffer,
+                                                                     int numCh)
+{
+    processSamples (buffer, numCh);
+}
+
+template <int FftOrder, bool LowLatency>
+template <typename SampleType>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::processSamples (juce::AudioBuffer<SampleType>& buffer,
+                                                                            int numCh)
+{
+    // ── Process channels in lock-step spans ──────────────────────────────────
+    //  Every channel is advanced over the same span before any frame is
+    //  processed, so frames run in time order (ch 0, 1, … N−1, then the next
+    //  hop) whatever the host block size, and simultaneous frames of adjacent
+    //  channels can share one FFT.
+    const int  numSamples   = buffer.getNumSamples();
+    const bool pairChannels = owner.usePairedStereoFFT.load (std::memory_order_relaxed);
+
+    blockOutputEnergy = 0.0f;
+
+    for (int start = 0; start < numSamples;)
+    {
+        updateWetPathState();
+
+        // ── Largest span that stays inside every channel's current hop ───────
+        //  Hop boundaries are multiples of hopSize, which divides fftSize,
+        //  so a span never wraps the input FIFO or the output accumulator.
+        //  A warm-up after bypass also ends on a span boundary.
+        int n = numSamples - start;
+        for (int ch = 0; ch < numCh; ++ch)
+            n = std::min (n, channels[ch].samplesUntilHop);
+
+        if (wetWarmUpRemaining > 0)
+            n = std::min (n, wetWarmUpRemaining);
+
+        const auto fifoStart = ProcessTiming::now();
+
+        // ── Feed STFT ────────────────────────────────────────────────────────
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            auto& state = channels[ch];
+            feedSpan (state, buffer.getWritePointer (ch) + start, n);
+            state.outputReadPos = (state.outputReadPos + n) & accumMask;
+        }
+
+        owner.timing.addStage (ProcessTiming::fifoStage, ProcessTiming::now() - fifoStart);
+
+        if (wetPathIdle)
+        {
+            // Bypassed: the buffer already holds the delayed input.
+            if (channels[0].frameDue)
+                trackBypassedFrames (numCh);
+
+            for (int ch = 0; ch < numCh; ++ch)
+                blockOutputEnergy += sumOfSquares (buffer.getReadPointer (ch) + start, n);
+        }
+        else
+        {
+            // The new frames are overlap-added from outputReadPos onwards,
+            // which never reaches back into the span we are about to read.
+            processDueFrames (numCh, pairChannels);
+
+            if (wetWarmUpRemaining > 0)
+            {
+                // Overlap-add still incomplete after bypass: stay dry.
+                wetWarmUpRemaining -= n;
+
+                for (int ch = 0; ch < numCh; ++ch)
+                {
+                    auto& state = channels[ch];
+                    std::fill_n (state.outputAccum.data() + ((state.outputReadPos - n) & accumMask), n, 0.0f);
+                    blockOutputEnergy += sumOfSquares (buffer.getReadPointer (ch) + start, n);
+                }
+            }
+            else
+            {
+                ProcessTiming::ScopedStage mixTiming (owner.timing, ProcessTiming::fifoStage);
+                mixSpan (buffer, start, n, numCh);
+            }
+        }
+
+        start += n;
+    }
+}
+
+//==============================================================================
+//  FIFO feed over one span of one channel
+//  The FIFO doubles as the dry delay line: io is left holding the input from
+//  exactly latency samples ago, used for clamping and the bypass mix.  The
+//  caller advances outputReadPos.
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+template <typename SampleType>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::feedSpan (ChannelState& state, SampleType* io, int n)
+{
+    if constexpr (std::is_same_v<SampleType, double>)
+    {
+        // The FIFO takes the analysis input in float; the dry signal goes
+        // through its own double delay line.  With latency = fftSize each
+        // slot is read before it is overwritten.
+        jassert (! state.dryDelay.empty());
+
+        double* dry     = state.dryDelay.data();
+        float*  fifo    = state.inputFifo.data() + state.fifoWritePos;
+        const int dryRd = (state.fifoWritePos - synthesisLength) & fifoMask;
+        const int dryWr = state.fifoWritePos;
+
+        for (int i = 0; i < n; ++i)
+        {
+            const double x = io[i];
+            io[i]          = dry[dryRd + i];
+            dry[dryWr + i] = x;
+            fifo[i]        = static_cast<float> (x);
+        }
+    }
+    else if constexpr (synthesisLength == fftSize)
+    {
+        // The slot being overwritten is the delayed input – swap.
+        std::swap_ranges (io, io + n, state.inputFifo.data() + state.fifoWritePos);
+    }
+    else
+    {
+        // The delayed input sits a whole number of hops back, so it neither
+        // wraps nor overlaps the slot being written.
+        std::copy (io, io + n, state.inputFifo.data() + state.fifoWritePos);
+        std::copy_n (state.inputFifo.data() + ((state.fifoWritePos - synthesisLength) & fifoMask), n, io);
+    }
+
+    state.hopEnergy += HisstoryKernels::sumOfSquares (state.inputFifo.data() + state.fifoWritePos, n);
+
+    state.fifoWritePos     = (state.fifoWritePos + n) & fifoMask;
+    state.samplesUntilHop -= n;
+
+    if (state.samplesUntilHop == 0)
+    {
+        state.samplesUntilHop = hopSize;
+        state.frameDue = true;
+
+        state.hopEnergies[static_cast<size_t> (state.hopEnergyPos)] = state.hopEnergy;
+        state.hopEnergyPos = (state.hopEnergyPos + 1) % hopsPerFrame;
+        state.hopEnergy    = 0.0f;
+    }
+}
+
+//==============================================================================
+//  Output stage: safety clamp and wet/dry mix over one span
+//  The bypass ramp advances once per sample position, so every channel sees
+//  the same crossfade.  Only ramp samples take gains from the table; the
+//  rest of the span runs at constant gain, which at steady state is clamped
+//  wet or untouched dry.
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+template <typename SampleType>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::mixSpan (juce::AudioBuffer<SampleType>& buffer,
+                                                                     int start, int n, int numCh)
+{
+    const int rampCount = std::min (n, owner.bypassRampSamplesRemaining);
+
+    float rampWetMix = owner.bypassWetMix;
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        auto& state    = channels[ch];
+        SampleType* io = buffer.getWritePointer (ch) + start;
+        float* accum   = state.outputAccum.data() + ((state.outputReadPos - n) & accumMask);
+
+        rampWetMix = owner.bypassWetMix;
+
+        for (int i = 0; i < rampCount; ++i)
+        {
+            rampWetMix = (i == owner.bypassRampSamplesRemaining - 1)
+                       ? owner.bypassTargetWetMix
+                       : rampWetMix + owner.bypassWetMixStep;
+
+            const float wetMix = juce::jlimit (0.0f, 1.0f, rampWetMix);
+            const SampleType dry = io[i];
+            const SampleType wet = clampToDry<SampleType> (accum[i], dry);
+            io[i] = dry * equalPowerGain (1.0f - wetMix) + wet * equalPowerGain (wetMix);
+        }
+
+        blockOutputEnergy += sumOfSquares (io, rampCount)
+                           + mixAtConstantGain (io + rampCount, accum + rampCount, n - rampCount,
+                                                juce::jlimit (0.0f, 1.0f, rampWetMix));
+
+        std::fill (accum, accum + n, 0.0f);
+    }
+
+    owner.bypassWetMix                = rampWetMix;
+    owner.bypassRampSamplesRemaining -= rampCount;
+}
+
+//==============================================================================
+//  Frame I/O: FIFO → analysis window, synthesis window → overlap-add
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::readFrame (const ChannelState& ch, float* dest)
+{
+    // Unroll the circular FIFO (oldest sample first) with two block copies.
+    const int oldestCount = fftSize - ch.fifoWritePos;
+    std::copy (ch.inputFifo.begin() + ch.fifoWritePos, ch.inputFifo.end(), dest);
+    std::copy (ch.inputFifo.begin(), ch.inputFifo.begin() + ch.fifoWritePos, dest + oldestCount);
+
+    juce::FloatVectorOperations::multiply (dest, analysisWindow.data(), fftSize);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::overlapAdd (ChannelState& ch, float* frame, float correction)
+{
+    // Only the synthesis window's non-zero tail is windowed and added; it
+    // lands at the current read position, which sets the latency.
+    float* tail = frame + synthesisStart;
+    juce::FloatVectorOperations::multiply (tail, synthesisWindow.data() + synthesisStart, synthesisLength);
+
+    // Overlap-add into the accumulator, split where it wraps.
+    const int firstSpan = std::min (synthesisLength, fftSize * 2 - ch.outputReadPos);
+    juce::FloatVectorOperations::addWithMultiply (ch.outputAccum.data() + ch.outputReadPos,
+                                                  tail, correction, firstSpan);
+    juce::FloatVectorOperations::addWithMultiply (ch.outputAccum.data(),
+                                                  tail + firstSpan, correction,
+                                                  synthesisLength - firstSpan);
+}
+
+//==============================================================================
+//  Frame scheduling
+//  Frames that fall due together are grouped into transform units – adjacent
+//  channel pairs sharing one complex FFT, or single channels.  A hop then
+//  runs in three phases:
+//    1. forward transforms, one task per unit (worker pool when enabled)
+//    2. processSpectrum for every channel, in channel order – the noise
+//       tracker and running statistics are shared, so this stays serial
+//    3. inverse transforms + overlap-add, one task per unit (unity-gain
+//       frames overlap-add their windowed input instead)
+//  The phases only reorder independent work, so the output is identical
+//  whether the units run inline or on the pool.
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::processDueFrames (int numCh, bool pairChannels)
+{
+    // Channel 0 feeds the editor.
+    const bool displayFrame = channels[0].frameDue && isDisplayFrame();
+
+    // Silent frames drop out here, before any transform is scheduled.
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        auto& state = channels[ch];
+
+        if (state.frameDue && isSilentFrame (state))
+        {
+            state.frameDue    = false;
+            state.frameSilent = true;
+        }
+    }
+
+    numFrameUnits = 0;
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        if (! channels[ch].frameDue)
+            continue;
+
+        const bool pairWithNext = pairChannels && ch + 1 < numCh && channels[ch + 1].frameDue;
+        frameUnits[numFrameUnits++] = { ch, pairWithNext ? ch + 1 : -1 };
+
+        if (pairWithNext)
+            ++ch;
+    }
+
+    if (numFrameUnits > 0)
+        owner.channelWorkers.run (forwardTransformTask, this, numFrameUnits);
+
+    // Per-bin updates stay in channel order, silent or not.
+    const bool skipUnityGain = owner.skipUnityGainFrames.load (std::memory_order_relaxed);
+    uint64_t numProcessed = 0, numSilent = 0, numUnityGain = 0;
+    const auto spectrumStart = ProcessTiming::now();
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        auto& state = channels[ch];
+
+        if (state.frameDue)
+        {
+            processSpectrum (state.spectrum.data(), state, ch == 0 && displayFrame, numCh);
+            state.frameDue       = false;
+            state.frameUnityGain = skipUnityGain && isUnityGainFrame (state);
+            ++numProcessed;
+        }
+        else if (state.frameSilent)
+        {
+            skipSilentFrame (state, ch == 0 && displayFrame, numCh);
+            state.frameSilent = false;
+            ++numSilent;
+        }
+    }
+
+    owner.timing.addStage (ProcessTiming::spectrumStage, ProcessTiming::now() - spectrumStart);
+
+    // A pair shares one inverse FFT, so it takes the shortcut only if both
+    // channels qualify; count the frames that actually do.
+    for (int i = 0; i < numFrameUnits; ++i)
+    {
+        const auto& unit = frameUnits[(size_t) i];
+        auto& first = channels[unit.first];
+
+        if (unit.second >= 0)
+        {
+            auto& second = channels[unit.second];
+            first.frameUnityGain = second.frameUnityGain = first.frameUnityGain && second.frameUnityGain;
+            numUnityGain += second.frameUnityGain ? 1 : 0;
+        }
+
+        numUnityGain += first.frameUnityGain ? 1 : 0;
+    }
+
+    if (numFrameUnits > 0)
+        owner.channelWorkers.run (inverseTransformTask, this, numFrameUnits);
+
+    owner.countFrames (numProcessed + numSilent, numSilent, numUnityGain);
+
+    if constexpr (ProcessTiming::enabled)
+    {
+        for (int i = 0; i < numFrameUnits; ++i)
+        {
+            const auto& unit = frameUnits[(size_t) i];
+            owner.timing.addStage (ProcessTiming::forwardFftStage, unit.forwardTicks);
+            owner.timing.addStage (ProcessTiming::inverseFftStage, unit.inverseTicks - unit.overlapAddTicks);
+            owner.timing.addStage (ProcessTiming::overlapAddStage, unit.overlapAddTicks);
+        }
+    }
+}
+
+//==============================================================================
+//  Silent frames (see SpectralEngine.h)
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+bool HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::isSilentFrame (const ChannelState& ch) const noexcept
+{
+    float energy = 0.0f;
+    for (const float e : ch.hopEnergies)
+        energy += e;
+
+    return energy < silentFrameEnergy;
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::skipSilentFrame (ChannelState& ch,
+                                                                             bool updateSharedData,
+                                                                             int numActiveChannels)
+{
+    HisstoryKernels::FrameContext ctx;
+    fillFrameContext (ctx, nullptr, ch, numActiveChannels);
+    HisstoryKernels::decaySilentFrame (ctx);
+
+    if (updateSharedData)
+    {
+        // Nothing was analysed: an empty spectrum, read as pure noise.
+        scratch.mags.fill (0.0f);
+        scratch.stationarity.fill (1.0f);
+        pushDisplayFrame (ch);
+    }
+}
+
+//==============================================================================
+//  Unity-gain frames (see SpectralEngine.h)
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+bool HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::isUnityGainFrame (const ChannelState& ch) const noexcept
+{
+    return juce::FloatVectorOperations::findMinimum (ch.prevGain.data(), numBins) >= unityGainThreshold;
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::overlapAddDirect (ChannelState& ch)
+{
+    // The FIFO still holds this frame's input: re-window it in place of the
+    // processed frame.
+    readFrame (ch, ch.spectrum.data());
+    overlapAdd (ch, ch.spectrum.data(), directWindowCorrection);
+}
+
+//==============================================================================
+//  Bypass fast path (see SpectralEngine.h)
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::updateWetPathState()
+{
+    const bool settled = owner.bypassRampSamplesRemaining == 0 && owner.bypassTargetWetMix <= 0.0f;
+
+    if (settled == wetPathIdle)
+        return;
+
+    wetPathIdle = settled;
+
+    if (settled)
+    {
+        // Drop the tails of the last wet frames so that a later warm-up
+        // overlap-adds into a clean accumulator.
+        for (auto& ch : channels)
+            ch.outputAccum.fill (0.0f);
+
+        wetWarmUpRemaining = 0;
+        hopsSinceTracked   = 0;
+    }
+    else
+    {
+        // Every output sample of the next synthesisLength is still missing
+        // the frames skipped while idle.
+        wetWarmUpRemaining = synthesisLength;
+    }
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::trackBypassedFrames (int numCh)
+{
+    for (int ch = 0; ch < numCh; ++ch)
+        channels[ch].frameDue = false;
+
+    ++hopsSinceTracked;
+    const bool displayFrame = isDisplayFrame();
+
+    if (! owner.trackNoiseWhileBypassed.load (std::memory_order_relaxed))
+        return;
+
+    if (hopsSinceTracked < bypassTrackerInterval && ! displayFrame)
+        return;
+
+    // One step over k hops: retention^k, and 1 − (1 − rate)^k for rates.
+    const float k = static_cast<float> (hopsSinceTracked);
+    auto overHops = [k] (float rate) { return 1.0f - std::pow (1.0f - rate, k); };
+
+    HisstoryKernels::FrameContext ctx;
+    fillFrameContext (ctx, nullptr, channels[0], numCh);
+    ctx.prevGain    = nullptr;                  // gains are frozen while bypassed
+    ctx.statAlpha   = std::pow (statAlpha, k);
+    ctx.floorAttack = overHops (floorAttack);
+    ctx.fastRelease = overHops (fastRelease);
+    ctx.slowRelease = overHops (slowRelease);
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        auto& state = channels[ch];
+
+        if (isSilentFrame (state))
+        {
+            HisstoryKernels::decaySilentFrame (ctx);
+
+            if (ch == 0 && displayFrame)
+            {
+                scratch.mags.fill (0.0f);
+                scratch.stationarity.fill (1.0f);
+                pushDisplayFrame (state);
+            }
+
+            continue;
+        }
+
+        readFrame (state, state.spectrum.data());
+        state.fft->forwardReal (state.spectrum.data());
+
+        ctx.fftData = state.spectrum.data();
+        HisstoryKernels::analyseBins (ctx, 0, numBins);
+
+        if (ch == 0 && displayFrame)
+            pushDisplayFrame (state);
+    }
+
+    hopsSinceTracked = 0;
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::forwardTransformTask (void* engine, int unitIndex)
+{
+    auto& e    = *static_cast<Engine*> (engine);
+    auto& unit = e.frameUnits[unitIndex];
+
+    const auto start = ProcessTiming::now();
+    e.forwardTransform (unit);
+    ProcessTiming::addElapsed (unit.forwardTicks, start);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::inverseTransformTask (void* engine, int unitIndex)
+{
+    auto& e    = *static_cast<Engine*> (engine);
+    auto& unit = e.frameUnits[unitIndex];
+
+    // Includes the unit's overlap-add, which processDueFrames takes back out.
+    const auto start = ProcessTiming::now();
+    e.inverseTransform (unit);
+    ProcessTiming::addElapsed (unit.inverseTicks, start);
+}
+
+//==============================================================================
+//  Transform units
+//  A pair shares one complex FFT: z = a + i·b.  With Z = FFT(z),
+//      A[k] = (Z[k] + conj Z[N−k]) / 2,   B[k] = (Z[k] − conj Z[N−k]) / 2i
+//  and on the way back Z[k] = A[k] + i·B[k] over the full circle (using
+//  Hermitian symmetry for k > N/2), so the real part of the inverse is the
+//  processed frame of the first channel and the imaginary part the second.
+//  Both directions work inside the two channels' spectrum buffers (or, on
+//  the offline path, their slots).
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::forwardTransform (const FrameUnit& unit)
+{
+    auto& first = channels[unit.first];
+
+    if (unit.second < 0)
+    {
+        readFrame (first, first.spectrum.data());
+        first.fft->forwardReal (first.spectrum.data());
+        return;
+    }
+
+    auto& second = channels[unit.second];
+    float* specB = second.spectrum.data();
+
+    readFrame (first,  specB);
+    readFrame (second, specB + fftSize);
+    forwardPair (*first.fft, first.spectrum.data(), specB);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::forwardPair (FftBackend& fft, float* specA, float* specB)
+{
+    // specB holds the two windowed frames, a then b.
+    auto* packed = reinterpret_cast<std::complex<float>*> (specA);
+    auto* zSpec  = reinterpret_cast<std::complex<float>*> (specB);
+
+    // ── Pack a + i·b ─────────────────────────────────────────────────────────
+    for (int i = 0; i < fftSize; ++i)
+        packed[i] = { specB[i], specB[fftSize + i] };
+
+    fft.performComplex (packed, zSpec, false);
+
+    // ── Separate the two half-spectra ────────────────────────────────────────
+    //  B[k] overwrites Z[k] in place; Z[N−k] lies above N/2 and is never
+    //  overwritten before it is read.
+    for (int k = 0; k < numBins; ++k)
+    {
+        const auto zk = zSpec[k];
+        const auto zm = zSpec[(fftSize - k) & fifoMask];
+
+        specA[2 * k]     = 0.5f * (zk.real() + zm.real());
+        specA[2 * k + 1] = 0.5f * (zk.imag() - zm.imag());
+        specB[2 * k]     = 0.5f * (zk.imag() + zm.imag());
+        specB[2 * k + 1] = 0.5f * (zm.real() - zk.real());
+    }
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::inverseTransform (FrameUnit& unit)
+{
+    auto& first = channels[unit.first];
+
+    if (unit.second < 0)
+    {
+        if (first.frameUnityGain)
+        {
+            const auto olaStart = ProcessTiming::now();
+            overlapAddDirect (first);
+            ProcessTiming::addElapsed (unit.overlapAddTicks, olaStart);
+            return;
+        }
+
+        first.fft->inverseReal (first.spectrum.data());
+
+        const auto olaStart = ProcessTiming::now();
+        overlapAdd (first, first.spectrum.data(), owner.windowCorrection);
+        ProcessTiming::addElapsed (unit.overlapAddTicks, olaStart);
+        return;
+    }
+
+    auto& second = channels[unit.second];
+
+    if (first.frameUnityGain)      // both, or neither (processDueFrames)
+    {
+        const auto olaStart = ProcessTiming::now();
+        overlapAddDirect (first);
+        overlapAddDirect (second);
+        ProcessTiming::addElapsed (unit.overlapAddTicks, olaStart);
+        return;
+    }
+
+    float* specA = first.spectrum.data();
+    inversePair (*first.fft, specA, second.spectrum.data());
+
+    const auto olaStart = ProcessTiming::now();
+    overlapAdd (first,  specA, owner.windowCorrection);
+    overlapAdd (second, specA + fftSize, owner.windowCorrection);
+    ProcessTiming::addElapsed (unit.overlapAddTicks, olaStart);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::inversePair (FftBackend& fft, float* specA, float* specB)
+{
+    // Leaves the first channel's processed frame in specA and the second's
+    // in specA + fftSize (synthesis tails only).
+    auto* zSpec = reinterpret_cast<std::complex<float>*> (specA);
+    auto* frame = reinterpret_cast<std::complex<float>*> (specB);
+
+    // ── Recombine over the full circle (in place in specA) ───────────────────
+    //  Z[N−k] lands above bin N/2, clear of the half-spectrum still to read.
+    for (int k = 0; k < numBins; ++k)
+    {
+        const float aRe = specA[2 * k], aIm = specA[2 * k + 1];
+        const float bRe = specB[2 * k], bIm = specB[2 * k + 1];
+
+        if (k > 0 && k < fftSize / 2)
+            zSpec[fftSize - k] = { aRe + bIm, bRe - aIm };
+
+        zSpec[k] = { aRe - bIm, aIm + bRe };
+    }
+
+    fft.performComplex (zSpec, frame, true);
+
+    // ── Unpack each channel (synthesis tail only) ────────────────────────────
+    float* frameA = specA;
+    float* frameB = specA + fftSize;
+
+    for (int i = synthesisStart; i < fftSize; ++i)
+    {
+        frameA[i] = frame[i].real();
+        frameB[i] = frame[i].imag();
+    }
+}
+
+//==============================================================================
+//  Offline three-phase STFT (see SpectralEngine.h)
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+bool HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::canProcessOffline (int numCh) const noexcept
+{
+    // Fully wet and settled: no crossfade, warm-up or idle hops to replay.
+    return ! offlineLanes.empty() && numCh > 0
+        && ! wetPathIdle && wetWarmUpRemaining == 0
+        && owner.bypassRampSamplesRemaining == 0 && owner.bypassTargetWetMix >= 1.0f;
+}
+
+template <int FftOrder, bool LowLatency>
+const float* HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineFrameInput (int frame, int ch) const noexcept
+{
+    return offlineHistory.data() + static_cast<size_t> (ch * offlineHistoryLength + offlineFrameOffsets[(size_t) frame]);
+}
+
+template <int FftOrder, bool LowLatency>
+float* HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineSpectrum (int frame, int ch) noexcept
+{
+    return offlineSpectra.data() + static_cast<size_t> (frame * numOfflineChannels + ch) * (fftSize * 2);
+}
+
+template <int FftOrder, bool LowLatency>
+int HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::processOfflinePass (juce::AudioBuffer<float>& buffer,
+                                                                               int start, int numCh,
+                                                                               bool pairChannels)
+{
+    const int passLength = std::min (buffer.getNumSamples() - start, offlineFramesPerPass * hopSize);
+
+    offlineBuffer      = &buffer;
+    numOfflineChannels = numCh;
+    numOfflineSpans    = 0;
+    numOfflineUnits    = 0;
+
+    // ── A. Feed the FIFOs span by span, recording frames and units ───────────
+    const auto fifoStart = ProcessTiming::now();
+
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        // The FIFO unrolled (oldest first), then the input still to come:
+        // each frame of the pass is an fftSize slice of it.
+        const auto& state = channels[ch];
+        float* history = offlineHistory.data() + static_cast<size_t> (ch * offlineHistoryLength);
+
+        std::copy (state.inputFifo.begin() + state.fifoWritePos, state.inputFifo.end(), history);
+        std::copy (state.inputFifo.begin(), state.inputFifo.begin() + state.fifoWritePos,
+                   history + fftSize - state.fifoWritePos);
+        std::copy_n (buffer.getReadPointer (ch) + start, passLength, history + fftSize);
+    }
+
+    int offset = 0, numFrames = 0;
+
+    while (offset < passLength && numFrames < offlineFramesPerPass)
+    {
+        int n = passLength - offset;
+        for (int ch = 0; ch < numCh; ++ch)
+            n = std::min (n, channels[ch].samplesUntilHop);
+
+        bool anyDue = false;
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            feedSpan (channels[ch], buffer.getWritePointer (ch) + start + offset, n);
+            anyDue = anyDue || channels[ch].frameDue;
+        }
+
+        auto& span = offlineSpans[(size_t) numOfflineSpans++];
+        span   = { start + offset, n, anyDue ? numFrames : -1 };
+        offset += n;
+
+        if (! anyDue)
+            continue;
+
+        const int frame = numFrames++;
+        OfflineSlot* slots = &offlineSlots[(size_t) (frame * numCh)];
+        offlineFrameOffsets[(size_t) frame] = offset;
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            auto& state = channels[ch];
+            slots[ch] = {};
+
+            if (state.frameDue)
+            {
+                slots[ch].silent = isSilentFrame (state);
+                slots[ch].due    = ! slots[ch].silent;
+                state.frameDue   = false;
+            }
+        }
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            if (! slots[ch].due)
+                continue;
+
+            const bool pairWithNext = pairChannels && ch + 1 < numCh && slots[ch + 1].due;
+            offlineUnits[(size_t) numOfflineUnits++] = { frame, ch, pairWithNext ? ch + 1 : -1 };
+
+            if (pairWithNext)
+                ++ch;
+        }
+    }
+
+    owner.timing.addStage (ProcessTiming::fifoStage, ProcessTiming::now() - fifoStart);
+
+    // ── 1. Forward transforms, units dealt across the lanes ──────────────────
+    numOfflineTasks = std::min (static_cast<int> (offlineLanes.size()), numOfflineUnits);
+
+    for (auto& lane : offlineLanes)
+        lane.forwardTicks = lane.inverseTicks = 0;
+
+    if (numOfflineUnits > 0)
+        owner.offlineWorkers.run (offlineForwardTask, this, numOfflineTasks);
+
+    // ── 2. Per-bin updates in time and channel order ─────────────────────────
+    const bool skipUnityGain = owner.skipUnityGainFrames.load (std::memory_order_relaxed);
+    uint64_t numProcessed = 0, numSilent = 0, numUnityGain = 0;
+    const auto spectrumStart = ProcessTiming::now();
+
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        OfflineSlot* slots = &offlineSlots[(size_t) (frame * numCh)];
+
+        // As in processDueFrames: a silent channel-0 frame still counts.
+        const bool displayFrame = (slots[0].due || slots[0].silent) && isDisplayFrame();
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            auto& state = channels[ch];
+
+            if (slots[ch].due)
+            {
+                processSpectrum (offlineSpectrum (frame, ch), state, ch == 0 && displayFrame, numCh);
+                slots[ch].unityGain = skipUnityGain && isUnityGainFrame (state);
+                ++numProcessed;
+            }
+            else if (slots[ch].silent)
+            {
+                skipSilentFrame (state, ch == 0 && displayFrame, numCh);
+                ++numSilent;
+            }
+        }
+    }
+
+    owner.timing.addStage (ProcessTiming::spectrumStage, ProcessTiming::now() - spectrumStart);
+
+    // Pairs as in processDueFrames: both channels or neither.
+    for (int i = 0; i < numOfflineUnits; ++i)
+    {
+        const auto& unit = offlineUnits[(size_t) i];
+        auto& first = offlineSlots[(size_t) (unit.frame * numCh + unit.first)];
+
+        if (unit.second >= 0)
+        {
+            auto& second = offlineSlots[(size_t) (unit.frame * numCh + unit.second)];
+            first.unityGain = second.unityGain = first.unityGain && second.unityGain;
+            numUnityGain += second.unityGain ? 1 : 0;
+        }
+
+        numUnityGain += first.unityGain ? 1 : 0;
+    }
+
+    owner.countFrames (numProcessed + numSilent, numSilent, numUnityGain);
+
+    // ── 3. Inverse transforms on the lanes, then overlap-add and mix per channel
+    if (numOfflineUnits > 0)
+        owner.offlineWorkers.run (offlineInverseTask, this, numOfflineTasks);
+
+    owner.offlineWorkers.run (offlineOverlapAddTask, this, numCh);
+
+    // Summed in processSamples' order: span by span, channel by channel.
+    for (int i = 0; i < numOfflineSpans * numCh; ++i)
+        blockOutputEnergy += offlineEnergy[(size_t) i];
+
+    if constexpr (ProcessTiming::enabled)
+    {
+        for (const auto& lane : offlineLanes)
+        {
+            owner.timing.addStage (ProcessTiming::forwardFftStage, lane.forwardTicks);
+            owner.timing.addStage (ProcessTiming::inverseFftStage, lane.inverseTicks);
+        }
+
+        for (int ch = 0; ch < numCh; ++ch)
+        {
+            owner.timing.addStage (ProcessTiming::overlapAddStage, offlineChannelTicks[(size_t) ch].overlapAddTicks);
+            owner.timing.addStage (ProcessTiming::fifoStage,       offlineChannelTicks[(size_t) ch].mixTicks);
+        }
+    }
+
+    offlineBuffer = nullptr;
+    return start + offset;
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineForward (int laneIndex)
+{
+    auto& lane = offlineLanes[(size_t) laneIndex];
+    const auto forwardStart = ProcessTiming::now();
+
+    for (int i = laneIndex; i < numOfflineUnits; i += numOfflineTasks)
+    {
+        const auto& unit = offlineUnits[(size_t) i];
+        float* specA = offlineSpectrum (unit.frame, unit.first);
+
+        // Windowed straight from the history, as readFrame does from the FIFO.
+        if (unit.second < 0)
+        {
+            juce::FloatVectorOperations::multiply (specA, offlineFrameInput (unit.frame, unit.first),
+                                                   analysisWindow.data(), fftSize);
+            lane.fft->forwardReal (specA);
+            continue;
+        }
+
+        float* specB = offlineSpectrum (unit.frame, unit.second);
+        juce::FloatVectorOperations::multiply (specB, offlineFrameInput (unit.frame, unit.first),
+                                               analysisWindow.data(), fftSize);
+        juce::FloatVectorOperations::multiply (specB + fftSize, offlineFrameInput (unit.frame, unit.second),
+                                               analysisWindow.data(), fftSize);
+        forwardPair (*lane.fft, specA, specB);
+    }
+
+    ProcessTiming::addElapsed (lane.forwardTicks, forwardStart);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineInverse (int laneIndex)
+{
+    auto& lane = offlineLanes[(size_t) laneIndex];
+    const auto inverseStart = ProcessTiming::now();
+
+    // Leaves each due slot's processed (or, at unity gain, re-windowed input)
+    // frame for offlineOverlapAdd.
+    auto setFrame = [] (OfflineSlot& slot, float* frame, float correction)
+    {
+        slot.olaFrame   = frame;
+        slot.correction = correction;
+    };
+
+    auto rewindow = [this, &setFrame] (OfflineSlot& slot, int frame, int ch)
+    {
+        float* dest = offlineSpectrum (frame, ch);
+        juce::FloatVectorOperations::multiply (dest, offlineFrameInput (frame, ch), analysisWindow.data(), fftSize);
+        setFrame (slot, dest, directWindowCorrection);
+    };
+
+    for (int i = laneIndex; i < numOfflineUnits; i += numOfflineTasks)
+    {
+        const auto& unit = offlineUnits[(size_t) i];
+        auto& first  = offlineSlots[(size_t) (unit.frame * numOfflineChannels + unit.first)];
+        float* specA = offlineSpectrum (unit.frame, unit.first);
+
+        if (unit.second < 0)
+        {
+            if (first.unityGain)
+            {
+                rewindow (first, unit.frame, unit.first);
+                continue;
+            }
+
+            lane.fft->inverseReal (specA);
+            setFrame (first, specA, owner.windowCorrection);
+            continue;
+        }
+
+        auto& second = offlineSlots[(size_t) (unit.frame * numOfflineChannels + unit.second)];
+
+        if (first.unityGain)       // both, or neither
+        {
+            rewindow (first,  unit.frame, unit.first);
+            rewindow (second, unit.frame, unit.second);
+            continue;
+        }
+
+        inversePair (*lane.fft, specA, offlineSpectrum (unit.frame, unit.second));
+        setFrame (first,  specA,           owner.windowCorrection);
+        setFrame (second, specA + fftSize, owner.windowCorrection);
+    }
+
+    ProcessTiming::addElapsed (lane.inverseTicks, inverseStart);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineOverlapAdd (int ch)
+{
+    // One channel's accumulator, replayed exactly as processSamples would:
+    // advance, overlap-add any frame due at the span's end, then mix the span.
+    auto& state  = channels[ch];
+    auto& ticks  = offlineChannelTicks[(size_t) ch];
+    float* io    = offlineBuffer->getWritePointer (ch);
+    const float wetMix = juce::jlimit (0.0f, 1.0f, owner.bypassWetMix);
+
+    ticks = {};
+
+    for (int i = 0; i < numOfflineSpans; ++i)
+    {
+        const auto& span = offlineSpans[(size_t) i];
+        state.outputReadPos = (state.outputReadPos + span.n) & accumMask;
+
+        if (span.frame >= 0)
+        {
+            const auto& slot = offlineSlots[(size_t) (span.frame * numOfflineChannels + ch)];
+
+            if (slot.due)
+            {
+                const auto olaStart = ProcessTiming::now();
+                overlapAdd (state, slot.olaFrame, slot.correction);
+                ProcessTiming::addElapsed (ticks.overlapAddTicks, olaStart);
+            }
+        }
+
+        const auto mixStart = ProcessTiming::now();
+        float* accum = state.outputAccum.data() + ((state.outputReadPos - span.n) & accumMask);
+
+        // No ramp here: mixSpan's empty ramp sum adds an exact 0.0f.
+        offlineEnergy[(size_t) (i * numOfflineChannels + ch)]
+            = mixAtConstantGain (io + span.start, accum, span.n, wetMix);
+
+        std::fill (accum, accum + span.n, 0.0f);
+        ProcessTiming::addElapsed (ticks.mixTicks, mixStart);
+    }
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineForwardTask (void* engine, int lane)
+{
+    static_cast<Engine*> (engine)->offlineForward (lane);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineInverseTask (void* engine, int lane)
+{
+    static_cast<Engine*> (engine)->offlineInverse (lane);
+}
+
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::offlineOverlapAddTask (void* engine, int ch)
+{
+    static_cast<Engine*> (engine)->offlineOverlapAdd (ch);
+}
+
+//==============================================================================
+//  Kernel frame context: this engine's per-bin arrays, scratch and rates
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::fillFrameContext (HisstoryKernels::FrameContext& ctx,
+                                                                              float* fftData,
+                                                                              ChannelState& ch,
+                                                                              int numActiveChannels)
+{
+    // ── Parameters ───────────────────────────────────────────────────────────
+    const float reductionDB   = owner.pReduction->load();
+    const float smoothPct     = perHopRetention (owner.pSmoothing->load() / 100.0f);
+    const bool  isAdaptive    = owner.pAdaptive->load() > 0.5f;
+
+    const float spectralFloor = juce::Decibels::decibelsToGain (-60.0f);
+    const float alpha         = 1.5f + (reductionDB / 40.0f) * 2.5f;
+
+    ctx.fftData           = fftData;
+    ctx.noiseProfile      = noiseProfile.data();
+    ctx.runningMean       = runningMean.data();
+    ctx.runningMeanSq     = runningMeanSq.data();
+    ctx.prevGain          = ch.prevGain.data();
+    ctx.perBinThreshold   = perBinThreshold.data();
+    ctx.noiseBias         = binCoefficients.noiseBias.data();
+    ctx.mags              = scratch.mags.data();
+    ctx.magsSq            = scratch.magsSq.data();
+    ctx.stationarity      = scratch.stationarity.data();
+    ctx.isPeak            = scratch.isPeak.data();
+    ctx.alphaScale        = scratch.alphaScale.data();
+    ctx.gains             = scratch.gains.data();
+    ctx.statAlpha         = statAlpha;
+    ctx.floorAttack       = floorAttack;
+    ctx.fastRelease       = fastRelease;
+    ctx.slowRelease       = slowRelease;
+    ctx.gainAttack        = gainAttack;
+    ctx.alpha             = alpha;
+    ctx.spectralFloor     = spectralFloor;
+    ctx.releaseCoeff      = smoothPct;
+    ctx.numActiveChannels = static_cast<float> (numActiveChannels);
+    ctx.adaptive          = isAdaptive;
+    ctx.numBins           = numBins;
+}
+
+//==============================================================================
+//  processSpectrum – core spectral-gating loop (vectorised)
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::processSpectrum (float* fftData,
+                                                                 ChannelState& ch,
+                                                                 bool updateSharedData,
+                                                                 int numActiveChannels)
+{
+    if (owner.useReferenceKernels.load (std::memory_order_relaxed))
+    {
+        processSpectrumReference (fftData, ch, updateSharedData, numActiveChannels);
+        return;
+    }
+
+    HisstoryKernels::FrameContext ctx;
+    fillFrameContext (ctx, fftData, ch, numActiveChannels);
+
+    // ── Magnitude → tracker → stationarity → gain → smoothing → apply ────────
+    //  Stationarity is computed once and shared by the tracker's release gate
+    //  and the gain stage.  Both drivers give the same result.
+    if (owner.useTiledFrameUpdate.load (std::memory_order_relaxed))
+        HisstoryKernels::processFrameTiled (ctx);
+    else
+        HisstoryKernels::processFrameStaged (ctx);
+
+    if (updateSharedData)
+        pushDisplayFrame (ch);
+}
+
+//==============================================================================
+//  processSpectrumReference – scalar reference implementation
+//  Kept verbatim as the ground truth for the vectorised kernels (its
+//  per-frame arrays live in the engine's scratch rather than on the stack).
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+void HisstoryAudioProcessor::Engine<FftOrder, LowLatency>::processSpectrumReference (float* fftData,
+                                                                          ChannelState& ch,
+                                                                          bool updateSharedData,
+                                                                          int numActiveChannels)
+{
+    // ── Parameters ───────────────────────────────────────────────────────────
+    const float reductionDB   = owner.pReduction->load();
+    const float smoothPct     = perHopRetention (owner.pSmoothing->load() / 100.0f);
+    const bool  isAdaptive    = owner.pAdaptive->load() > 0.5f;
+
+    // Spectral floor: max attenuation applied per bin.
+    // -60 dB preserves a tiny residual, avoiding complete "holes" in the
+    // audio that sound unnatural and cause music loss.
+    const float spectralFloor = juce::Decibels::decibelsToGain (-60.0f);
+
+    // Oversubtraction factor: 1.5–4.0 (reduced from 2.0–8.0 for less
+    // aggressive removal and better music preservation).
+    const float alpha = 1.5f + (reductionDB / 40.0f) * 2.5f;
+
+    const float sr    = owner.currentSampleRate.load();
+    const float binHz = sr / static_cast<float> (fftSize);
+
+    // ── Compute magnitudes, update noise tracker, and track stationarity ──
+    auto& mags   = scratch.mags;
+    auto& magsSq = scratch.magsSq;
+
+    // Stationarity tracking coefficient: the statAlpha member (~0.77 s time
+    // constant at 44.1 kHz, whatever the hop).
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float re = fftData[2 * bin];
+        const float im = fftData[2 * bin + 1];
+        magsSq[bin] = re * re + im * im;
+        mags[bin]   = std::sqrt (magsSq[bin]);
+
+        runningMean[bin]   = statAlpha * runningMean[bin]   + (1.0f - statAlpha) * mags[bin];
+        runningMeanSq[bin] = statAlpha * runningMeanSq[bin] + (1.0f - statAlpha) * magsSq[bin];
+
+        // ── Adaptive noise floor tracker ──────────────────────────────────
+        //  Converges UPWARD from near-zero: the release branch grows the
+        //  profile toward the observed signal; the attack branch pulls it
+        //  down.  Equilibrium ≈ 14th percentile of the magnitude distribution
+        //  (close to the noise floor for Rayleigh-distributed noise).
+        //  The release is gated by stationarity so that the profile only
+        //  rises in noise-like (stationary) bins, protecting the estimate
+        //  from being inflated by musical content.
+        if (isAdaptive)
+        {
+            if (mags[bin] < noiseProfile[bin])
+            {
+                // Fast attack: converge down toward minimum
+                const float attackRate = floorAttack / static_cast<float> (numActiveChannels);
+                noiseProfile[bin] += attackRate * (mags[bin] - noiseProfile[bin]);
+            }
+            else
+            {
+                // Stationarity-gated release: only grow in noise-like bins
+                const float mean   = runningMean[bin];
+                const float meanSq = runningMeanSq[bin];
+                const float var    = std::max (0.0f, meanSq - mean * mean);
+                const float stddev = std::sqrt (var);
+                const float cv     = (mean > 1e-10f) ? (stddev / mean) : 0.0f;
+
+                // Stationarity: 1.0 = noise-like (low CV), 0.0 = music (high CV)
+                const float stationarity = 1.0f - juce::jlimit (0.0f, 1.0f,
+                                                                  (cv - 0.5f) / 1.0f);
+
+                // Faster initial convergence when profile is far from signal
+                const float baseRelease =
+                    (noiseProfile[bin] < mags[bin] * 0.1f) ? fastRelease : slowRelease;
+
+                const float releaseRate = baseRelease * stationarity
+                                        / static_cast<float> (numActiveChannels);
+
+                noiseProfile[bin] += releaseRate * (mags[bin] - noiseProfile[bin]);
+            }
+        }
+    }
+
+    // ── Tonal peak detection (protect harmonics from over-gating) ─────────
+    //  Protect bins that are at least 7 dB above neighbours (5× power),
+    //  and extend protection to immediate neighbours.
+    auto& isTonalPeak = scratch.isTonalPeak;
+    isTonalPeak.fill (false);
+    for (int bin = 3; bin < numBins - 3; ++bin)
+    {
+        float neighborAvg = (magsSq[bin - 2] + magsSq[bin - 1]
+                           + magsSq[bin + 1] + magsSq[bin + 2]) * 0.25f;
+
+        if (magsSq[bin] > neighborAvg * 5.0f)
+        {
+            isTonalPeak[bin] = true;
+            if (bin > 0)            isTonalPeak[bin - 1] = true;
+            if (bin < numBins - 1)  isTonalPeak[bin + 1] = true;
+        }
+    }
+
+    // ── Pre-compute per-bin stationarity (for music-aware gating) ─────────
+    auto& binStationarity = scratch.stationarity;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float mean   = runningMean[bin];
+        const float meanSq = runningMeanSq[bin];
+        const float var    = std::max (0.0f, meanSq - mean * mean);
+        const float stddev = std::sqrt (var);
+        const float cv     = (mean > 1e-10f) ? (stddev / mean) : 0.0f;
+
+        // 1.0 = noise-like, 0.0 = music-like
+        binStationarity[bin] = 1.0f - juce::jlimit (0.0f, 1.0f,
+                                                      (cv - 0.5f) / 1.0f);
+    }
+
+    // ── Per-bin gain computation (Wiener-style spectral subtraction) ──────
+    auto& gains = scratch.gains;
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float freq = static_cast<float> (bin) * binHz;
+
+        // Frequency-dependent noise bias (reduced from 2.5 to 1.8 for HF):
+        //   Below 2 kHz: 1.1 (conservative, preserve signal)
+        //   2–4 kHz: ramp 1.1 → 1.8
+        //   Above 4 kHz: 1.8 (target hiss, but gentler than before)
+        float noiseBias;
+        if (freq < 2000.0f)
+            noiseBias = 1.1f;
+        else if (freq < 4000.0f)
+            noiseBias = 1.1f + 0.7f * ((freq - 2000.0f) / 2000.0f);
+        else
+            noiseBias = 1.8f;
+
+        const float noiseEst   = noiseProfile[bin];
+        const float thrMult    = perBinThreshold[bin];
+        const float noiseLevel = noiseEst * thrMult * noiseBias;
+
+        float gain = 1.0f;
+
+        if (magsSq[bin] > 1e-20f)
+        {
+            const float noiseSq = noiseLevel * noiseLevel;
+
+            // Base alpha, reduced for tonal peaks
+            float binAlpha = isTonalPeak[bin] ? (alpha * 0.15f) : alpha;
+
+            // Stationarity-aware alpha: reduce gating for music-like bins.
+            // Noise bins (stationarity≈1) get full alpha.
+            // Music bins (stationarity≈0) get 30% of alpha.
+            const float stFactor = 0.3f + 0.7f * binStationarity[bin];
+            binAlpha *= stFactor;
+
+            const float subtracted = 1.0f - binAlpha * (noiseSq / magsSq[bin]);
+            gain = std::sqrt (std::max (0.0f, subtracted));
+        }
+
+        gain = juce::jlimit (spectralFloor, 1.0f, gain);
+        gains[bin] = gain;
+    }
+
+    // ── Frequency smoothing (3-tap) ──────────────────────────────────────────
+    {
+        auto& s = scratch.smoothed;
+        s[0] = 0.667f * gains[0] + 0.333f * gains[1];
+
+        for (int b = 1; b < numBins - 1; ++b)
+            s[b] = 0.25f * gains[b - 1]
+                 + 0.50f * gains[b]
+                 + 0.25f * gains[b + 1];
+
+        s[numBins - 1] = 0.333f * gains[numBins - 2] + 0.667f * gains[numBins - 1];
+        gains = s;
+    }
+
+    // ── Wider frequency smoothing (5-tap, music-safe) ────────────────────────
+    {
+        auto& s = scratch.smoothed;
+        s[0] = gains[0];
+        s[1] = 0.25f * gains[0] + 0.50f * gains[1] + 0.25f * gains[2];
+
+        for (int b = 2; b < numBins - 2; ++b)
+            s[b] = 0.1f  * gains[b - 2]
+                 + 0.2f  * gains[b - 1]
+                 + 0.4f  * gains[b]
+                 + 0.2f  * gains[b + 1]
+                 + 0.1f  * gains[b + 2];
+
+        s[numBins - 2] = 0.25f * gains[numBins - 3]
+                        + 0.50f * gains[numBins - 2]
+                        + 0.25f * gains[numBins - 1];
+        s[numBins - 1] = gains[numBins - 1];
+        gains = s;
+    }
+
+    // ── Asymmetric temporal smoothing & apply gains ─────────────────────────
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const float prev = ch.prevGain[bin];
+        float g;
+
+        if (gains[bin] > prev)
+        {
+            const float attackCoeff = gainAttack;
+            g = prev + attackCoeff * (gains[bin] - prev);
+        }
+        else
+        {
+            const float releaseCoeff = smoothPct;
+            g = prev + (1.0f - releaseCoeff) * (gains[bin] - prev);
+        }
+
+        g = juce::jlimit (spectralFloor, 1.0f, g);
+        ch.prevGain[bin] = g;
+
+        fftData[2 * bin]     *= g;
+        fftData[2 * bin + 1] *= g;
+    }
+
+    // ── Display spectra and quality metrics (analysis worker) ───────────────
+    if (updateSharedData)
+        pushDisplayFrame (ch);
+}
+
+//==============================================================================
+//  Instantiations (one per supported FFT order and latency mode)
+//==============================================================================
+template class HisstoryAudioProcessor::Engine<10, false>;
+template class HisstoryAudioProcessor::Engine<11, false>;
+template class HisstoryAudioProcessor::Engine<12, false>;
+template class HisstoryAudioProcessor::Engine<13, false>;
+template class HisstoryAudioProcessor::Engine<14, false>;
+
+template class HisstoryAudioProcessor::Engine<10, true>;
+template class HisstoryAudioProcessor::Engine<11, true>;
+template class HisstoryAudioProcessor::Engine<12, true>;
+template class HisstoryAudioProcessor::Engine<13, true>;
+template class HisstoryAudioProcessor::Engine<14, true>;
@@ -0,0 +1,457 @@
+/*
+  ==============================================================================
+    Hisstory – SpectralEngine.h
+
+    The STFT core of the de-hisser, templated on FFT order so that every size
+    keeps the fixed-size, cache-aligned per-bin layout (no heap or large stack
+    buffers on the audio thread).  Orders minFftOrder–maxFftOrder (1024 to
+    16384 points) are instantiated in SpectralEngine.cpp and one is picked per
+    processor instance at prepareToPlay.
+      • Short FFTs trade frequency resolution for latency and CPU (live use).
+      • Long FFTs separate hiss from tones more finely (offline mastering).
+    The noise tracker and gain smoothing were tuned per 1024-sample hop; other
+    sizes rescale their per-frame rates so the time constants stay the same.
+    The editor always sees spectra on the displayFftSize grid; other sizes
+    are resampled onto it when a snapshot is published.
+
+    Each order also has a low-latency instantiation.  It keeps the full-length
+    analysis window for frequency resolution, but uses an asymmetric
+    analysis / synthesis pair whose synthesis window only spans the last
+    2 · lowLatencyHopSize samples of the frame (Mauler & Martin's low-delay
+    design).  Latency drops from fftSize to that span, at the cost of a frame
+    every lowLatencyHopSize samples.
+  ==============================================================================
+*/
+
+#pragma once
+#include "PluginProcessor.h"
+#include "FftBackend.h"
+
+namespace HisstoryKernels { struct FrameContext; }
+
+//==============================================================================
+//  Size-independent interface the processor drives
+//==============================================================================
+struct HisstoryAudioProcessor::EngineBase
+{
+    virtual ~EngineBase() = default;
+
+    virtual int  getFftOrder() const noexcept = 0;
+    virtual int  getFftSize()  const noexcept = 0;
+    virtual bool isLowLatency() const noexcept = 0;
+    virtual int  getLatencySamples() const noexcept = 0;
+    virtual FftBackend::Kind getFftBackend() const noexcept = 0;
+
+    /** Sizes the per-channel state, creates the processor's requested FFT
+        backend and builds the per-bin tables for the processor's sample
+        rate.  Not real-time safe. */
+    virtual void prepare (int numChannels) = 0;
+
+    /** Runs the STFT, safety clamp and bypass crossfade in place over the
+        first numChannels channels of the buffer. */
+    virtual void process (juce::AudioBuffer<float>& buffer, int numChannels) = 0;
+
+    /** 64-bit I/O.  The STFT still runs in float, but the dry path (delay
+        line, clamp reference and crossfade) stays in double, so bypass is
+        bit-transparent.  Needs a prepare() made while the processor was set
+        to double precision. */
+    virtual void process (juce::AudioBuffer<double>& buffer, int numChannels) = 0;
+
+    /** Sum of squares of every output sample the last process() call wrote,
+        over all channels – measured while writing them, for the processor's
+        silence-gap detector. */
+    virtual float getBlockOutputEnergy() const noexcept = 0;
+
+    virtual void generateDefaultNoiseProfile() = 0;
+    virtual void resetAdaptiveProfile() = 0;
+    virtual void updatePerBinThreshold() = 0;
+};
+
+//==============================================================================
+template <int FftOrder, bool LowLatency>
+class HisstoryAudioProcessor::Engine final : public EngineBase
+{
+public:
+    static constexpr int  fftOrder   = FftOrder;
+    static constexpr bool lowLatency = LowLatency;
+    static constexpr int  fftSize    = 1 << fftOrder;
+    static constexpr int  numBins    = fftSize / 2 + 1;
+
+    /** Standard: 75 % overlap.  Low latency: one frame per lowLatencyHopSize. */
+    static constexpr int  hopSize    = lowLatency ? lowLatencyHopSize : fftSize / 4;
+    static constexpr int  hopsPerFrame = fftSize / hopSize;
+
+    /** Length of the non-zero tail of the synthesis window, i.e. how much of
+        each processed frame is overlap-added – and so the latency. */
+    static constexpr int  synthesisLength = lowLatency ? 2 * hopSize : fftSize;
+    static constexpr int  synthesisStart  = fftSize - synthesisLength;
+
+    /** Overlap-added sum of analysis × synthesis windows: Hann² at 75 %
+        overlap, or a periodic Hann over synthesisLength at 50 %. */
+    static constexpr float colaSum = lowLatency ? 1.0f : 1.5f;
+
+    static_assert (fftOrder >= minFftOrder && fftOrder <= maxFftOrder,
+                   "FFT order outside the instantiated range");
+    static_assert (fftSize % hopSize == 0 && synthesisLength <= fftSize,
+                   "hops must tile the FIFO and the synthesis span fit the frame");
+
+    explicit Engine (HisstoryAudioProcessor& processor);
+
+    int  getFftOrder() const noexcept override { return fftOrder; }
+    int  getFftSize()  const noexcept override { return fftSize; }
+    bool isLowLatency() const noexcept override { return lowLatency; }
+    int  getLatencySamples() const noexcept override { return synthesisLength; }
+    FftBackend::Kind getFftBackend() const noexcept override { return fftBackend; }
+    float getBlockOutputEnergy() const noexcept override { return blockOutputEnergy; }
+
+    void prepare (int numChannels) override;
+    void process (juce::AudioBuffer<float>& buffer, int numChannels) override;
+    void process (juce::AudioBuffer<double>& buffer, int numChannels) override;
+    void generateDefaultNoiseProfile() override;
+    void resetAdaptiveProfile() override;
+    void updatePerBinThreshold() override;
+
+private:
+    HisstoryAudioProcessor& owner;
+
+    //==========================================================================
+    //  Analysis / synthesis windows (FFT engines live in ChannelState)
+    //  Standard: Hann for both (peak = 1.0, COLA = 1.5 for Hann²).
+    //  Low latency: asymmetric pair built in buildWindows().
+    //==========================================================================
+    alignas(64) std::array<float, fftSize> analysisWindow;
+    alignas(64) std::array<float, fftSize> synthesisWindow;
+
+    void  buildWindows();
+
+    //==========================================================================
+    //  Per-channel STFT state
+    //  The FIFO, accumulator, gains and hop energies are left uninitialised
+    //  here: prepare() resets every channel before use, so constructing one
+    //  does not clear them twice.
+    //==========================================================================
+    struct ChannelState
+    {
+        std::array<float, fftSize>      inputFifo;      // also the dry delay line (latency ≤ fftSize)
+        std::array<float, fftSize * 2>  outputAccum;
+        int   fifoWritePos    = 0;
+        int   outputReadPos   = 0;
+        int   samplesUntilHop = hopSize;
+        alignas(64) std::array<float, numBins> prevGain;
+        float signalLevel     = 0.0f;   // smoothed frame-level (dB) for quiet detection
+        bool  frameDue        = false;  // hop reached in the current span
+        bool  frameSilent     = false;  // …and found silent: state update only
+        bool  frameUnityGain  = false;  // …or processed at unity gain: no inverse FFT
+
+        // Input energy of each of the last hopsPerFrame hops (a ring; together
+        // they cover the FIFO) plus the hop in progress, for isSilentFrame().
+        std::array<float, hopsPerFrame> hopEnergies;
+        float hopEnergy       = 0.0f;
+        int   hopEnergyPos    = 0;
+
+        // FFT work buffer: windowed frame → spectrum → processed frame.  Each
+        // channel owns its FFT backend (which may keep work buffers of its
+        // own) so transforms can run on worker threads.
+        // Never cleared per frame: readFrame() writes the first fftSize
+        // samples before every forward transform, and the upper half is the
+        // transform's own output space.
+        alignas(64) std::array<float, fftSize * 2> spectrum {};
+        std::unique_ptr<FftBackend> fft;
+
+        // Full-precision dry delay line (indexed like inputFifo), sized in
+        // prepare only when the host processes in double.
+        std::vector<double> dryDelay;
+
+        void reset();
+    };
+
+    std::vector<ChannelState> channels;   // sized in prepare
+
+    /** Ring-buffer index masks (both buffer sizes are powers of two). */
+    static constexpr int fifoMask  = fftSize - 1;
+    static constexpr int accumMask = fftSize * 2 - 1;
+
+    //==========================================================================
+    //  Frame scheduling: transform units (see processDueFrames)
+    //==========================================================================
+    struct FrameUnit
+    {
+        int first  = 0;
+        int second = -1;    // paired channel, or -1 for a single real FFT
+
+        // Stage time of this unit, written by whichever thread ran it and
+        // added to owner.timing by processDueFrames.
+        ProcessTiming::Ticks forwardTicks    = 0;
+        ProcessTiming::Ticks inverseTicks    = 0;
+        ProcessTiming::Ticks overlapAddTicks = 0;
+    };
+
+    std::vector<FrameUnit> frameUnits;      // capacity = channel count
+    int                    numFrameUnits = 0;
+    FftBackend::Kind       fftBackend = FftBackend::Kind::automatic;   // resolved in prepare
+
+    //==========================================================================
+    //  Per-bin spectral state (structure of arrays)
+    //  Kept together and cache-line aligned for the vectorised frame update
+    //  in SpectralKernels.h.
+    //
+    //  noiseProfile   – tracked noise magnitude per bin
+    //  runningMean/Sq – exponential averages of magnitude and magnitude².
+    //                   The coefficient of variation (stddev / mean) indicates
+    //                   how stationary a bin is: low CV = noise-like,
+    //                   high CV = music-like.
+    //==========================================================================
+    alignas(64) std::array<float, numBins>  noiseProfile    {};
+    alignas(64) std::array<float, numBins>  runningMean     {};
+    alignas(64) std::array<float, numBins>  runningMeanSq   {};
+
+    //==========================================================================
+    //  Pre-computed per-bin coefficient tables
+    //  Geometry (frequency, band interpolation, noise bias) depends only on the
+    //  sample rate and is rebuilt in prepare.  The threshold multiplier is
+    //  rebuilt whenever the processor's thresholdParamsVersion moves.
+    //==========================================================================
+    struct BinCoefficients
+    {
+        std::array<float, numBins> frequency    {};   // Hz
+        std::array<float, numBins> logFrequency {};   // log2 Hz (≥ 1 Hz)
+        std::array<int,   numBins> bandIndex    {};   // lower control point
+        std::array<float, numBins> bandWeight   {};   // 0–1 toward bandIndex + 1
+        alignas(64) std::array<float, numBins> noiseBias {};
+    };
+
+    BinCoefficients binCoefficients;
+    alignas(64) std::array<float, numBins> perBinThreshold {};
+
+    //==========================================================================
+    //  Per-frame rates
+    //  Tuned for the default size's hop and rescaled here so that every FFT
+    //  size tracks noise and smooths gains with the same time constants.
+    //==========================================================================
+    static constexpr int   defaultHopSize = displayFftSize / 4;
+    static constexpr float hopRatio = static_cast<float> (hopSize) / static_cast<float> (defaultHopSize);
+
+    /** Per-frame retention (fraction of the old value kept) at this hop. */
+    static float perHopRetention (float k) noexcept
+    {
+        if constexpr (hopSize == defaultHopSize)  return k;
+        else                                      return std::pow (k, hopRatio);
+    }
+
+    /** Per-frame rate (fraction of the gap closed) at this hop. */
+    static float perHopRate (float r) noexcept
+    {
+        if constexpr (hopSize == defaultHopSize)  return r;
+        else                                      return 1.0f - std::pow (1.0f - r, hopRatio);
+    }
+
+    const float statAlpha   = perHopRetention (0.97f);   // ~0.77 s time constant at 44.1 kHz
+    const float floorAttack = perHopRate (0.06f);
+    const float fastRelease = perHopRate (0.03f);
+    const float slowRelease = perHopRate (0.01f);
+    const float gainAttack  = perHopRate (0.15f);
+
+    //==========================================================================
+    //  Per-frame scratch arena
+    //  One set of cache-aligned arrays per engine – allocated with it, so in
+    //  the constructor or prepareToPlay, never on the audio thread – shared
+    //  by every channel's frame (processSpectrum runs them one at a time).
+    //  processSpectrum, the reference path, the silent-frame update and the
+    //  bypass tracker keep nothing on the stack whatever the FFT order.
+    //  Each frame writes every entry it later reads (isPeak's edges through
+    //  clearPeakEdges, isTonalPeak by an explicit fill), so the arena is
+    //  never cleared, not even when constructed.
+    //==========================================================================
+    struct FrameScratch
+    {
+        alignas(64) std::array<float, numBins>     mags;
+        alignas(64) std::array<float, numBins>     magsSq;
+        alignas(64) std::array<float, numBins>     stationarity;
+        alignas(64) std::array<float, numBins + 2> isPeak;
+        alignas(64) std::array<float, numBins>     alphaScale;
+        alignas(64) std::array<float, numBins>     gains;
+
+        // Reference path only
+        std::array<bool,  numBins> isTonalPeak;
+        std::array<float, numBins> smoothed;
+    };
+
+    FrameScratch scratch;
+
+    //==========================================================================
+    //  Editor feed
+    //  Display frames are decimated to the editor's refresh rate; each one
+    //  hands its magnitudes, final gains, stationarity and the noise profile
+    //  to the processor's AnalysisWorker, which derives spectra and metrics
+    //  off the audio thread (so Residual Flux compares display frames).
+    //==========================================================================
+    int   snapshotIntervalSamples = 0;     // set in prepare
+    int   samplesUntilSnapshot    = 0;
+
+    /** Called once per channel-0 frame: true if it should feed the editor. */
+    bool  isDisplayFrame() noexcept;
+    void  pushDisplayFrame (const ChannelState& ch);
+    void  pushNoiseProfile (uint32_t flags);
+
+    //==========================================================================
+    //  Silent frames
+    //  A frame whose input mean power is below silentFramePower is skipped
+    //  outright – no window, transforms, gating or overlap-add; its output
+    //  would be below the noise floor anyway.  Per-bin state still advances
+    //  exactly as a frame of zeros would advance it (decaySilentFrame): the
+    //  statistics decay by statAlpha, the adaptive tracker attacks towards
+    //  0 and the smoothed gains relax towards 1, so output after a digital-
+    //  silence gap is unchanged by the skip.  The test uses the input
+    //  energy summed per hop as the FIFO is written – one sum of squares
+    //  per input sample and a hopsPerFrame-long sum per hop.  It is not the
+    //  processor's silence-gap measurement, which is blockOutputEnergy.
+    //==========================================================================
+    static constexpr float silentFrameEnergy = silentFramePower * static_cast<float> (fftSize);
+
+    float blockOutputEnergy = 0.0f;
+
+    bool  isSilentFrame   (const ChannelState& ch) const noexcept;
+    void  skipSilentFrame (ChannelState& ch, bool updateSharedData, int numActiveChannels);
+
+    //==========================================================================
+    //  Unity-gain frames
+    //  When every bin's final gain is at least unityGainThreshold – typical of
+    //  loud, dense passages – the processed frame is the windowed input to
+    //  within that margin, so the inverse transform is skipped and the
+    //  windowed FIFO is overlap-added directly (with 1 / colaSum in place of
+    //  the round-trip correction).  A pair takes the shortcut only when both
+    //  channels qualify.  Every bin is off by at most 1 − unityGainThreshold,
+    //  so by Parseval each such frame's contribution deviates from the full
+    //  path by at most 0.1 % (−60 dB) of its own level.
+    //==========================================================================
+    static constexpr float unityGainThreshold     = 0.999f;
+    static constexpr float directWindowCorrection = 1.0f / colaSum;
+
+    bool  isUnityGainFrame (const ChannelState& ch) const noexcept;
+    void  overlapAddDirect (ChannelState& ch);
+
+    //==========================================================================
+    //  Bypass fast path
+    //  Once the bypass crossfade has finished the wet path idles: only the
+    //  delay line runs, so latency is unchanged.  Unless the processor turns
+    //  it off, every bypassTrackerInterval-th hop (and every display frame)
+    //  still takes a forward FFT and updates the running statistics and
+    //  noise tracker, with rates rescaled for the hops skipped, so the
+    //  profile is current when bypass is released.  Leaving idle, frames run
+    //  for synthesisLength samples – until the overlap-add is whole again –
+    //  while the output stays dry; only then does the crossfade start.
+    //==========================================================================
+    static constexpr int bypassTrackerInterval = 4;
+
+    bool  wetPathIdle        = false;
+    int   wetWarmUpRemaining = 0;
+    int   hopsSinceTracked   = 0;
+
+    void  updateWetPathState();
+    void  trackBypassedFrames (int numCh);
+
+    //==========================================================================
+    //  Offline three-phase STFT (setOfflineStftThreads)
+    //  Within one processBlock() nothing flows from the output back into the
+    //  spectra – the silence-gap reset acts between blocks – so the block
+    //  can be taken apart by phase instead of by hop.  A pass of up to
+    //  offlineFramesPerPass hop boundaries runs:
+    //    A. the FIFO feed, span by span exactly as in processSamples, noting
+    //       where each frame falls due, which are silent and how they pair;
+    //       a frame's input is then a slice of the channel's history (the
+    //       FIFO unrolled at the start of the pass, followed by the input)
+    //    1. every frame's window and forward transform, on offline lanes
+    //    2. processSpectrum / skipSilentFrame for every frame in time and
+    //       channel order – the only step with a cross-frame dependency
+    //    3. every inverse transform on the lanes, then one task per channel
+    //       replays its overlap-adds and mixes span by span
+    //  Each lane owns an FFT backend of the same kind as the channels'.
+    //  The arithmetic and its order per accumulator sample match the
+    //  real-time path, so the output is bit-identical; blocks that start
+    //  idle, warming up or mid-crossfade take processSamples instead.
+    //==========================================================================
+    static constexpr int offlineFramesPerPass = 32;
+    static constexpr int offlineHistoryLength = fftSize + offlineFramesPerPass * hopSize;
+
+    struct OfflineSpan
+    {
+        int start = 0, n = 0;
+        int frame = -1;         // frame record at the span's end, or -1
+    };
+
+    struct OfflineSlot          // one channel of one frame record
+    {
+        bool   due       = false;
+        bool   silent    = false;
+        bool   unityGain = false;
+        float* olaFrame  = nullptr;     // set by phase 3 when due
+        float  correction = 0.0f;
+    };
+
+    struct OfflineUnit
+    {
+        int frame = 0, first = 0, second = -1;
+    };
+
+    struct OfflineLane
+    {
+        std::unique_ptr<FftBackend> fft;
+        ProcessTiming::Ticks forwardTicks = 0, inverseTicks = 0;
+    };
+
+    struct OfflineChannelTicks
+    {
+        ProcessTiming::Ticks overlapAddTicks = 0, mixTicks = 0;
+    };
+
+    std::vector<OfflineSpan>         offlineSpans;
+    std::vector<int>                 offlineFrameOffsets;   // pass offset of each frame record
+    std::vector<OfflineSlot>         offlineSlots;          // frame record × channel
+    std::vector<OfflineUnit>         offlineUnits;
+    std::vector<float>               offlineHistory;        // channel × offlineHistoryLength
+    std::vector<float>               offlineSpectra;        // slot × 2 · fftSize
+    std::vector<float>               offlineEnergy;         // span × channel
+    std::vector<OfflineLane>         offlineLanes;
+    std::vector<OfflineChannelTicks> offlineChannelTicks;
+    juce::AudioBuffer<float>*        offlineBuffer = nullptr;
+    int numOfflineChannels = 0, numOfflineSpans = 0, numOfflineUnits = 0, numOfflineTasks = 0;
+
+    bool  canProcessOffline (int numCh) const noexcept;
+    int   processOfflinePass (juce::AudioBuffer<float>& buffer, int start, int numCh, bool pairChannels);
+    const float* offlineFrameInput (int frame, int ch) const noexcept;
+    float* offlineSpectrum (int frame, int ch) noexcept;
+    void  offlineForward    (int lane);
+    void  offlineInverse    (int lane);
+    void  offlineOverlapAdd (int ch);
+    static void offlineForwardTask    (void* engine, int lane);
+    static void offlineInverseTask    (void* engine, int lane);
+    static void offlineOverlapAddTask (void* engine, int ch);
+
+    //==========================================================================
+    //  Internal helpers
+    //==========================================================================
+    template <typename SampleType>
+    void  processSamples     (juce::AudioBuffer<SampleType>& buffer, int numCh);
+    template <typename SampleType>
+    void  feedSpan           (ChannelState& state, SampleType* io, int n);
+    template <typename SampleType>
+    void  mixSpan            (juce::AudioBuffer<SampleType>& buffer, int start, int n, int numCh);
+
+    void  rebuildBinCoefficients();
+    void  updateWindowCorrection();
+    void  readFrame          (const ChannelState& ch, float* dest);
+    void  overlapAdd         (ChannelState& ch, float* frame, float correction);
+    void  processDueFrames   (int numCh, bool pairChannels);
+    void  forwardTransform   (const FrameUnit& unit);
+    void  inverseTransform   (FrameUnit& unit);
+    void  forwardPair        (FftBackend& fft, float* specA, float* specB);
+    void  inversePair        (FftBackend& fft, float* specA, float* specB);
+    static void forwardTransformTask (void* engine, int unitIndex);
+    static void inverseTransformTask (void* engine, int unitIndex);
+    void  fillFrameContext   (HisstoryKernels::FrameContext& ctx, float* fftData, ChannelState& ch,
+                              int numActiveChannels);
+    void  processSpectrum    (float* fftData, ChannelState& ch, bool updateSharedData, int numActiveChannels = 1);
+    void  processSpectrumReference (float* fftData, ChannelState& ch, bool updateSharedData, int numActiveChannels = 1);
+
+    JUCE_DECLARE_NON_COPYABLE (Engine)
+};
@@ -0,0 +1,610 @@
+/*
+  ==============================================================================
+    Hisstory – SpectralKernels.h
+
+    Vectorised per-bin kernels for the spectral gate.  Every stage is written
+    once as a branchless template over an "ops" policy, then instantiated with
+    a 4-wide SIMD policy (SSE2 or AArch64 NEON) for the bulk of the bins and
+    with a scalar policy for the remainder.  Both policies evaluate the same
+    expressions in the same order as HisstoryAudioProcessor's scalar reference
+    path, so results agree to within FMA-contraction rounding – except the
+    frequency smoothing, which folds the reference's two passes into one
+    7-tap kernel and so differs by float rounding.
+
+    The stages operate on bin ranges of a FrameContext (structure-of-arrays
+    state plus per-frame scratch).  processFrameStaged(), the engine's
+    default, runs each stage over the whole spectrum in turn;
+    processFrameTiled() runs them as a wavefront over cache-sized tiles so
+    each tile's working set stays in L1.  The results are identical, and
+    `Benchmark --kernels` compares the two at every FFT size.
+
+    clampAndMix() and sumOfSquares() are the engine's time-domain helpers,
+    built on the same policies: the output stage (4× safety clamp and a
+    constant-gain wet/dry mix) and the energy measurements behind silent-
+    frame skipping and the silence-gap detector.  FftBackend.cpp's built-in
+    SIMD transform uses the policies too.
+  ==============================================================================
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define HISSTORY_SIMD_SSE2 1
+#elif defined (__aarch64__) || defined (_M_ARM64)
+ #include <arm_neon.h>
+ #define HISSTORY_SIMD_NEON 1
+#endif
+
+namespace HisstoryKernels
+{
+    //==========================================================================
+    //  Ops policies
+    //==========================================================================
+    struct ScalarOps
+    {
+        using V = float;
+        using M = bool;
+        static constexpr int width = 1;
+
+        static V    load  (const float* p)        { return *p; }
+        static void store (float* p, V v)         { *p = v; }
+        static V    splat (float x)               { return x; }
+        static V    add   (V a, V b)              { return a + b; }
+        static V    sub   (V a, V b)              { return a - b; }
+        static V    mul   (V a, V b)              { return a * b; }
+        static V    div   (V a, V b)              { return a / b; }
+        static V    sqrt  (V a)                   { return std::sqrt (a); }
+        static V    min   (V a, V b)              { return b < a ? b : a; }
+        static V    max   (V a, V b)              { return a < b ? b : a; }
+        static M    lessThan    (V a, V b)        { return a < b; }
+        static M    greaterThan (V a, V b)        { return a > b; }
+        static V    select (M m, V a, V b)        { return m ? a : b; }
+        static float sum    (V v)                 { return v; }
+        static V    reverse (V v)                 { return v; }
+
+        static void loadDeinterleaved (const float* p, V& re, V& im) { re = p[0]; im = p[1]; }
+        static void storeInterleaved  (float* p, V re, V im)         { p[0] = re; p[1] = im; }
+        static void scaleInterleaved  (float* p, V g)                { p[0] *= g; p[1] *= g; }
+    };
+
+   #if HISSTORY_SIMD_SSE2
+    struct SimdOps
+    {
+        using V = __m128;
+        using M = __m128;
+        static constexpr int width = 4;
+
+        static V    load  (const float* p)        { return _mm_loadu_ps (p); }
+        static void store (float* p, V v)         { _mm_storeu_ps (p, v); }
+        static V    splat (float x)               { return _mm_set1_ps (x); }
+        static V    add   (V a, V b)              { return _mm_add_ps (a, b); }
+        static V    sub   (V a, V b)              { return _mm_sub_ps (a, b); }
+        static V    mul   (V a, V b)              { return _mm_mul_ps (a, b); }
+        static V    div   (V a, V b)              { return _mm_div_ps (a, b); }
+        static V    sqrt  (V a)                   { return _mm_sqrt_ps (a); }
+        static V    min   (V a, V b)              { return _mm_min_ps (b, a); }   // matches (b < a ? b : a)
+        static V    max   (V a, V b)              { return _mm_max_ps (b, a); }   // matches (a < b ? b : a)
+        static M    lessThan    (V a, V b)        { return _mm_cmplt_ps (a, b); }
+        static M    greaterThan (V a, V b)        { return _mm_cmpgt_ps (a, b); }
+        static V    select (M m, V a, V b)        { return _mm_or_ps (_mm_and_ps (m, a), _mm_andnot_ps (m, b)); }
+
+        static float sum (V v)
+        {
+            const V pairs = _mm_add_ps (v, _mm_movehl_ps (v, v));
+            return _mm_cvtss_f32 (_mm_add_ss (pairs, _mm_shuffle_ps (pairs, pairs, 1)));
+        }
+
+        static V    reverse (V v)                 { return _mm_shuffle_ps (v, v, _MM_SHUFFLE (0, 1, 2, 3)); }
+
+        static void loadDeinterleaved (const float* p, V& re, V& im)
+        {
+            const V lo = _mm_loadu_ps (p);
+            const V hi = _mm_loadu_ps (p + 4);
+            re = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (2, 0, 2, 0));
+            im = _mm_shuffle_ps (lo, hi, _MM_SHUFFLE (3, 1, 3, 1));
+        }
+
+        static void storeInterleaved (float* p, V re, V im)
+        {
+            _mm_storeu_ps (p,     _mm_unpacklo_ps (re, im));
+            _mm_storeu_ps (p + 4, _mm_unpackhi_ps (re, im));
+        }
+
+        /** Stores a0 a1 b0 b1 a2 a3 b2 b3. */
+        static void storeInterleavedPairs (float* p, V a, V b)
+        {
+            _mm_storeu_ps (p,     _mm_movelh_ps (a, b));
+            _mm_storeu_ps (p + 4, _mm_movehl_ps (b, a));
+        }
+
+        static void scaleInterleaved (float* p, V g)
+        {
+            _mm_storeu_ps (p,     _mm_mul_ps (_mm_loadu_ps (p),     _mm_unpacklo_ps (g, g)));
+            _mm_storeu_ps (p + 4, _mm_mul_ps (_mm_loadu_ps (p + 4), _mm_unpackhi_ps (g, g)));
+        }
+    };
+   #elif HISSTORY_SIMD_NEON
+    struct SimdOps
+    {
+        using V = float32x4_t;
+        using M = uint32x4_t;
+        static constexpr int width = 4;
+
+        static V    load  (const float* p)        { return vld1q_f32 (p); }
+        static void store (float* p, V v)         { vst1q_f32 (p, v); }
+        static V    splat (float x)               { return vdupq_n_f32 (x); }
+        static V    add   (V a, V b)              { return vaddq_f32 (a, b); }
+        static V    sub   (V a, V b)              { return vsubq_f32 (a, b); }
+        static V    mul   (V a, V b)              { return vmulq_f32 (a, b); }
+        static V    div   (V a, V b)              { return vdivq_f32 (a, b); }
+        static V    sqrt  (V a)                   { return vsqrtq_f32 (a); }
+        static V    min   (V a, V b)              { return vminq_f32 (a, b); }
+        static V    max   (V a, V b)              { return vmaxq_f32 (a, b); }
+        static M    lessThan    (V a, V b)        { return vcltq_f32 (a, b); }
+        static M    greaterThan (V a, V b)        { return vcgtq_f32 (a, b); }
+        static V    select (M m, V a, V b)        { return vbslq_f32 (m, a, b); }
+        static float sum    (V v)                 { return vaddvq_f32 (v); }
+        static V    reverse (V v)                 { const V r = vrev64q_f32 (v); return vextq_f32 (r, r, 2); }
+
+        static void loadDeinterleaved (const float* p, V& re, V& im)
+        {
+            const float32x4x2_t d = vld2q_f32 (p);
+            re = d.val[0];
+            im = d.val[1];
+        }
+
+        static void storeInterleaved (float* p, V re, V im)
+        {
+            vst2q_f32 (p, float32x4x2_t { { re, im } });
+        }
+
+        /** Stores a0 a1 b0 b1 a2 a3 b2 b3. */
+        static void storeInterleavedPairs (float* p, V a, V b)
+        {
+            vst1q_f32 (p,     vcombine_f32 (vget_low_f32 (a),  vget_low_f32 (b)));
+            vst1q_f32 (p + 4, vcombine_f32 (vget_high_f32 (a), vget_high_f32 (b)));
+        }
+
+        static void scaleInterleaved (float* p, V g)
+        {
+            float32x4x2_t d = vld2q_f32 (p);
+            d.val[0] = vmulq_f32 (d.val[0], g);
+            d.val[1] = vmulq_f32 (d.val[1], g);
+            vst2q_f32 (p, d);
+        }
+    };
+   #else
+    using SimdOps = ScalarOps;
+   #endif
+
+    /** Runs `body.template operator()<Ops> (begin, end)` with the SIMD policy over
+        the largest multiple-of-width prefix and the scalar policy over the rest. */
+    template <typename Body>
+    inline void forEachSpan (int begin, int end, Body&& body)
+    {
+        if (end <= begin)
+            return;
+
+        const int vecEnd = begin + ((end - begin) / SimdOps::width) * SimdOps::width;
+        body (SimdOps{}, begin, vecEnd);
+        body (ScalarOps{}, vecEnd, end);
+    }
+
+    //==========================================================================
+    //  Frame context: SoA views of all per-bin arrays touched by one frame
+    //==========================================================================
+    struct FrameContext
+    {
+        // Spectrum (interleaved re/im), gains are applied in place
+        float*       fftData         = nullptr;
+
+        // Persistent per-bin state
+        float*       noiseProfile    = nullptr;
+        float*       runningMean     = nullptr;
+        float*       runningMeanSq   = nullptr;
+        float*       prevGain        = nullptr;
+        const float* perBinThreshold = nullptr;
+        const float* noiseBias       = nullptr;
+
+        // Per-frame scratch.  isPeak holds numBins + 2 entries and is indexed
+        // from isPeak + 1 so the ±1 dilation never needs edge cases.
+        float*       mags            = nullptr;
+        float*       magsSq          = nullptr;
+        float*       stationarity    = nullptr;
+        float*       isPeak          = nullptr;
+        float*       alphaScale      = nullptr;
+        float*       gains           = nullptr;
+
+        // Parameters.  The per-frame rates below are the values for a
+        // 1024-sample hop; the engine rescales them for other hop sizes.
+        float statAlpha          = 0.97f;
+        float floorAttack        = 0.06f;   // noise tracker, toward lower magnitudes
+        float fastRelease        = 0.03f;   // noise tracker, profile far below signal
+        float slowRelease        = 0.01f;   // noise tracker, otherwise
+        float gainAttack         = 0.15f;   // gain smoothing toward higher gain
+        float alpha              = 1.0f;
+        float spectralFloor      = 0.0f;
+        float releaseCoeff       = 0.5f;
+        float numActiveChannels  = 1.0f;
+        bool  adaptive           = false;
+        int   numBins            = 0;
+    };
+
+    //==========================================================================
+    //  Stage 1 (pointwise): |X|, |X|², running mean / mean², stationarity
+    //  (1 = noise, 0 = music) and the adaptive noise-floor tracker, fused.
+    //==========================================================================
+    inline void analyseBins (const FrameContext& c, int begin, int end)
+    {
+        const float statBeta    = 1.0f - c.statAlpha;
+        const float floorAttack = c.floorAttack / c.numActiveChannels;
+
+        forEachSpan (begin, end, [&] (auto ops, int b0, int b1)
+        {
+            using O = decltype (ops);
+            const auto a        = O::splat (c.statAlpha);
+            const auto beta     = O::splat (statBeta);
+            const auto zero     = O::splat (0.0f);
+            const auto one      = O::splat (1.0f);
+            const auto half     = O::splat (0.5f);
+            const auto tiny     = O::splat (1e-10f);
+            const auto attack   = O::splat (floorAttack);
+            const auto nCh      = O::splat (c.numActiveChannels);
+            const auto fastRel  = O::splat (c.fastRelease);
+            const auto slowRel  = O::splat (c.slowRelease);
+            const auto farRatio = O::splat (0.1f);
+
+            for (int b = b0; b < b1; b += O::width)
+            {
+                typename O::V re, im;
+                O::loadDeinterleaved (c.fftData + 2 * b, re, im);
+                const auto sq  = O::add (O::mul (re, re), O::mul (im, im));
+                const auto mag = O::sqrt (sq);
+                O::store (c.magsSq + b, sq);
+                O::store (c.mags + b, mag);
+
+                const auto mean   = O::add (O::mul (a, O::load (c.runningMean + b)), O::mul (beta, mag));
+                const auto meanSq = O::add (O::mul (a, O::load (c.runningMeanSq + b)), O::mul (beta, sq));
+                O::store (c.runningMean + b, mean);
+                O::store (c.runningMeanSq + b, meanSq);
+
+                const auto var    = O::max (zero, O::sub (meanSq, O::mul (mean, mean)));
+                const auto cv     = O::select (O::greaterThan (mean, tiny),
+                                               O::div (O::sqrt (var), mean), zero);
+                const auto st     = O::sub (one, O::min (O::max (O::sub (cv, half), zero), one));
+                O::store (c.stationarity + b, st);
+
+                if (c.adaptive)
+                {
+                    // Fast attack toward lower magnitudes; release gated by
+                    // stationarity so the profile only rises in noise-like bins.
+                    const auto prof        = O::load (c.noiseProfile + b);
+                    const auto baseRelease = O::select (O::lessThan (prof, O::mul (mag, farRatio)),
+                                                        fastRel, slowRel);
+                    const auto release     = O::div (O::mul (baseRelease, st), nCh);
+                    const auto rate        = O::select (O::lessThan (mag, prof), attack, release);
+                    O::store (c.noiseProfile + b, O::add (prof, O::mul (rate, O::sub (mag, prof))));
+                }
+            }
+        });
+    }
+
+    //==========================================================================
+    //  Stage 2: tonal-peak detection.  A bin in [3, numBins - 3) is a peak if
+    //  its power exceeds 5× the mean of its ±2 neighbours.  Needs magsSq up to
+    //  bin + 2.  Peaks outside that range are cleared by clearPeakEdges().
+    //==========================================================================
+    inline void clearPeakEdges (const FrameContext& c)
+    {
+        std::fill (c.isPeak, c.isPeak + 4, 0.0f);                              // pad, 0, 1, 2
+        std::fill (c.isPeak + 1 + c.numBins - 3, c.isPeak + c.numBins + 2, 0.0f); // n-3 .. pad
+    }
+
+    inline void detectPeaks (const FrameContext& c, int begin, int end)
+    {
+        float* const peak = c.isPeak + 1;
+
+        forEachSpan (std::max (begin, 3), std::min (end, c.numBins - 3), [&] (auto ops, int b0, int b1)
+        {
+            using O = decltype (ops);
+            const auto quarter = O::splat (0.25f);
+            const auto five    = O::splat (5.0f);
+            const auto one     = O::splat (1.0f);
+            const auto zero    = O::splat (0.0f);
+
+            for (int b = b0; b < b1; b += O::width)
+            {
+                const auto sum = O::add (O::add (O::add (O::load (c.magsSq + b - 2),
+                                                         O::load (c.magsSq + b - 1)),
+                                                 O::load (c.magsSq + b + 1)),
+                                         O::load (c.magsSq + b + 2));
+                O::store (peak + b, O::select (O::greaterThan (O::load (c.magsSq + b),
+                                                               O::mul (O::mul (sum, quarter), five)),
+                                               one, zero));
+            }
+        });
+    }
+
+    //==========================================================================
+    //  Stage 3: tonal protection (peak ±1 → alpha × 0.15) fused with the
+    //  Wiener-style spectral-subtraction gain.  Needs isPeak up to bin + 1.
+    //==========================================================================
+    inline void gainBins (const FrameContext& c, int begin, int end)
+    {
+        const float* const peak = c.isPeak + 1;
+
+        forEachSpan (begin, end, [&] (auto ops, int b0, int b1)
+        {
+            using O = decltype (ops);
+            const auto a        = O::splat (c.alpha);
+            const auto tonal    = O::splat (0.15f);
+            const auto stBase   = O::splat (0.3f);
+            const auto stRange  = O::splat (0.7f);
+            const auto one      = O::splat (1.0f);
+            const auto zero     = O::splat (0.0f);
+            const auto silent   = O::splat (1e-20f);
+            const auto floorV   = O::splat (c.spectralFloor);
+
+            for (int b = b0; b < b1; b += O::width)
+            {
+                const auto near  = O::add (O::add (O::load (peak + b - 1), O::load (peak + b)),
+                                           O::load (peak + b + 1));
+                const auto scale = O::select (O::greaterThan (near, zero), tonal, one);
+                O::store (c.alphaScale + b, scale);
+
+                const auto noiseLevel = O::mul (O::mul (O::load (c.noiseProfile + b),
+                                                        O::load (c.perBinThreshold + b)),
+                                                O::load (c.noiseBias + b));
+                const auto sq      = O::load (c.magsSq + b);
+                const auto noiseSq = O::mul (noiseLevel, noiseLevel);
+
+                const auto binAlpha = O::mul (O::mul (a, scale),
+                                              O::add (stBase, O::mul (stRange, O::load (c.stationarity + b))));
+                const auto subtracted = O::sub (one, O::mul (binAlpha, O::div (noiseSq, sq)));
+                const auto wiener     = O::sqrt (O::max (zero, subtracted));
+                const auto gain       = O::select (O::greaterThan (sq, silent), wiener, one);
+
+                O::store (c.gains + b, O::min (O::max (gain, floorV), one));
+            }
+        });
+    }
+
+    //==========================================================================
+    //  Stage 4: frequency smoothing fused with temporal smoothing and apply.
+    //
+    //  The 3-tap [¼ ½ ¼] pass followed by the 5-tap [.1 .2 .4 .2 .1] pass is
+    //  a single symmetric 7-tap kernel [.025 .1 .225 .3 .225 .1 .025].  The
+    //  two passes' edge rules only reach the outermost three bins, which are
+    //  evaluated by composing the passes directly.  gains is only read, so
+    //  the stage needs no scratch and no copy-back; the smoothed gain goes
+    //  straight into the attack/release step, then onto the spectrum.
+    //  Needs gains up to bin + 3.
+    //==========================================================================
+    static constexpr int smoothingRadius = 3;
+
+    /** Two-pass smoothed gain at an edge bin (b < 3 or b >= n - 3). */
+    inline float edgeSmoothedGain (const float* g, int n, int b)
+    {
+        auto s3 = [g, n] (int i)
+        {
+            if (i == 0)     return 0.667f * g[0] + 0.333f * g[1];
+            if (i == n - 1) return 0.333f * g[n - 2] + 0.667f * g[n - 1];
+            return 0.25f * g[i - 1] + 0.50f * g[i] + 0.25f * g[i + 1];
+        };
+
+        if (b == 0 || b == n - 1)
+            return s3 (b);
+
+        if (b == 1 || b == n - 2)
+            return 0.25f * s3 (b - 1) + 0.50f * s3 (b) + 0.25f * s3 (b + 1);
+
+        return 0.1f * s3 (b - 2) + 0.2f * s3 (b - 1) + 0.4f * s3 (b)
+             + 0.2f * s3 (b + 1) + 0.1f * s3 (b + 2);
+    }
+
+    inline void smoothApplyBins (const FrameContext& c, int begin, int end)
+    {
+        const int n = c.numBins;
+        const float* g = c.gains;
+
+        auto temporalApply = [&c] (auto ops, int b, auto target)
+        {
+            using O = decltype (ops);
+            const auto prev  = O::load (c.prevGain + b);
+            const auto coeff = O::select (O::greaterThan (target, prev),
+                                          O::splat (c.gainAttack), O::splat (1.0f - c.releaseCoeff));
+            const auto gain  = O::min (O::max (O::add (prev, O::mul (coeff, O::sub (target, prev))),
+                                               O::splat (c.spectralFloor)), O::splat (1.0f));
+            O::store (c.prevGain + b, gain);
+            O::scaleInterleaved (c.fftData + 2 * b, gain);
+        };
+
+        const int innerBegin = std::max (begin, smoothingRadius);
+        const int innerEnd   = std::min (end, n - smoothingRadius);
+
+        for (int b = begin; b < std::min (end, smoothingRadius); ++b)
+            temporalApply (ScalarOps{}, b, edgeSmoothedGain (g, n, b));
+
+        forEachSpan (innerBegin, innerEnd, [&] (auto ops, int b0, int b1)
+        {
+            using O = decltype (ops);
+            const auto k0 = O::splat (0.300f);
+            const auto k1 = O::splat (0.225f);
+            const auto k2 = O::splat (0.100f);
+            const auto k3 = O::splat (0.025f);
+
+            for (int b = b0; b < b1; b += O::width)
+            {
+                const auto target = O::add (O::add (O::add (O::mul (k0, O::load (g + b)),
+                                                            O::mul (k1, O::add (O::load (g + b - 1), O::load (g + b + 1)))),
+                                                    O::mul (k2, O::add (O::load (g + b - 2), O::load (g + b + 2)))),
+                                            O::mul (k3, O::add (O::load (g + b - 3), O::load (g + b + 3))));
+                temporalApply (ops, b, target);
+            }
+        });
+
+        for (int b = std::max (begin, n - smoothingRadius); b < end; ++b)
+            temporalApply (ScalarOps{}, b, edgeSmoothedGain (g, n, b));
+    }
+
+    //==========================================================================
+    //  Silent frame: the state update a frame of zeros would make, without
+    //  the frame.  Magnitudes are 0, so the running statistics decay by
+    //  statAlpha, the adaptive tracker attacks towards 0, and every gain is
+    //  1 (the silent-bin gain), which the temporal smoothing approaches at
+    //  gainAttack.  Gains are left alone if prevGain is null.
+    //==========================================================================
+    inline void decaySilentFrame (const FrameContext& c)
+    {
+        const float floorAttack = c.floorAttack / c.numActiveChannels;
+
+        forEachSpan (0, c.numBins, [&] (auto ops, int b0, int b1)
+        {
+            using O = decltype (ops);
+            const auto a      = O::splat (c.statAlpha);
+            const auto zero   = O::splat (0.0f);
+            const auto one    = O::splat (1.0f);
+            const auto attack = O::splat (floorAttack);
+            const auto gAtk   = O::splat (c.gainAttack);
+            const auto gRel   = O::splat (1.0f - c.releaseCoeff);
+            const auto floorV = O::splat (c.spectralFloor);
+
+            for (int b = b0; b < b1; b += O::width)
+            {
+                O::store (c.runningMean + b,   O::mul (a, O::load (c.runningMean + b)));
+                O::store (c.runningMeanSq + b, O::mul (a, O::load (c.runningMeanSq + b)));
+
+                if (c.adaptive)
+                {
+                    const auto prof = O::load (c.noiseProfile + b);
+                    O::store (c.noiseProfile + b, O::add (prof, O::mul (attack, O::sub (zero, prof))));
+                }
+
+                if (c.prevGain != nullptr)
+                {
+                    const auto prev  = O::load (c.prevGain + b);
+                    const auto coeff = O::select (O::greaterThan (one, prev), gAtk, gRel);
+                    const auto gain  = O::min (O::max (O::add (prev, O::mul (coeff, O::sub (one, prev))),
+                                                       floorV), one);
+                    O::store (c.prevGain + b, gain);
+                }
+            }
+        });
+    }
+
+    //==========================================================================
+    //  Frame drivers
+    //==========================================================================
+    /** Runs every stage over the whole spectrum in turn. */
+    inline void processFrameStaged (const FrameContext& c)
+    {
+        const int n = c.numBins;
+        clearPeakEdges (c);
+        analyseBins (c, 0, n);
+        detectPeaks (c, 0, n);
+        gainBins        (c, 0, n);
+        smoothApplyBins (c, 0, n);
+    }
+
+    /** Default tile: ~12 KB of live per-bin data, comfortably inside L1d. */
+    static constexpr int defaultTileBins = 256;
+
+    /** Runs the stages as a wavefront over tiles of `tileBins` bins.  Each
+        stage trails the one before it by that stage's look-ahead, so a tile's
+        data is consumed by every stage while it is still cache-resident.
+        Produces exactly the same result as processFrameStaged(). */
+    inline void processFrameTiled (const FrameContext& c, int tileBins = defaultTileBins)
+    {
+        const int n = c.numBins;
+        clearPeakEdges (c);
+
+        int peaksDone = 0, gainsDone = 0, appliedDone = 0;
+
+        for (int tileStart = 0; tileStart < n; tileStart += tileBins)
+        {
+            const int  tileEnd = std::min (n, tileStart + tileBins);
+            const bool last    = (tileEnd == n);
+
+            analyseBins (c, tileStart, tileEnd);
+
+            auto advance = [&] (int& done, int target, auto stage)
+            {
+                target = last ? n : std::max (done, target);
+                stage (c, done, target);
+                done = target;
+            };
+
+            advance (peaksDone,   tileEnd   - 2, detectPeaks);
+            advance (gainsDone,   peaksDone - 1, gainBins);
+            advance (appliedDone, gainsDone - smoothingRadius, smoothApplyBins);
+        }
+    }
+
+    //==========================================================================
+    //  Output stage: the wet signal is clamped to 4× the delayed input (pulled
+    //  back to the input's level, or muted if the input is silent), then
+    //  mixed with it.  io holds the delayed input on entry and the output on
+    //  return.  With dryGain 0 and wetGain 1 the result is exactly the clamped
+    //  wet signal.  Returns the output's sum of squares.
+    //==========================================================================
+    inline float clampAndMix (float* io, const float* wet, int n, float dryGain, float wetGain)
+    {
+        float energy = 0.0f;
+
+        forEachSpan (0, n, [&] (auto ops, int i0, int i1)
+        {
+            using O = decltype (ops);
+            const auto zero   = O::splat (0.0f);
+            const auto four   = O::splat (4.0f);
+            const auto silent = O::splat (1e-8f);
+            const auto dg     = O::splat (dryGain);
+            const auto wg     = O::splat (wetGain);
+            auto       sumSq  = zero;
+
+            for (int i = i0; i < i1; i += O::width)
+            {
+                const auto dry    = O::load (io + i);
+                const auto out    = O::load (wet + i);
+                const auto absIn  = O::max (dry, O::sub (zero, dry));
+                const auto absOut = O::max (out, O::sub (zero, out));
+
+                const auto limited = O::select (O::greaterThan (absIn, silent),
+                                                O::mul (out, O::div (absIn, absOut)), zero);
+                const auto clamped = O::select (O::greaterThan (absOut, O::mul (absIn, four)), limited, out);
+
+                const auto mixed   = O::add (O::mul (dry, dg), O::mul (clamped, wg));
+                O::store (io + i, mixed);
+                sumSq = O::add (sumSq, O::mul (mixed, mixed));
+            }
+
+            energy += O::sum (sumSq);
+        });
+
+        return energy;
+    }
+
+    /** Sum of squares of n samples. */
+    inline float sumOfSquares (const float* x, int n)
+    {
+        float energy = 0.0f;
+
+        forEachSpan (0, n, [&] (auto ops, int i0, int i1)
+        {
+            using O = decltype (ops);
+            auto sumSq = O::splat (0.0f);
+
+            for (int i = i0; i < i1; i += O::width)
+            {
+                const auto v = O::load (x + i);
+                sumSq = O::add (sumSq, O::mul (v, v));
+            }
+
+            energy += O::sum (sumSq);
+        });
+
+        return energy;
+    }
+}
@@ -16,50 +16,224 @@
     Test 4 (Music Preservation):
       • Complex harmonic signal (chord) + noise
       • Verify: harmonic energy is preserved (< 3 dB loss)
+
+    Test 5 (Block-Size Independence):
+      • Mono and stereo input processed with 512-sample, irregular and
+        1-sample host blocks (1-sample blocks replay the original
+        per-sample FIFO loop: every span is a single sample)
+      • Verify: outputs are bit-identical
+
+    Test 6 (Vectorised Kernels):
+      • Chord + noise processed with the SIMD and scalar reference kernels,
+        and with the SIMD stages run staged (default) and tiled
+      • Verify: SIMD and reference agree within 1e-5 (float rounding only);
+        staged and tiled are bit-identical
+
+    Test 7 (Threshold Table Refresh):
+      • Threshold / band parameters changed after prepareToPlay
+      • Verify: output matches a processor prepared with those values
+
+    Test 8 (Paired Stereo FFT):
+      • Stereo processed with the paired complex FFT and per-channel FFTs
+      • Verify: outputs agree within 1e-5; mono is unaffected by the switch
+
+    Test 9 (Multichannel / Worker Pool):
+      • 5.1 and 5-channel (odd) material, inline vs 3 worker threads
+      • Verify: 5.1 layout accepted; outputs bit-identical
+
+    Test 10 (FFT Sizes):
+      • Noise and sine + noise at every FFT order (1024–16384 points)
+      • Verify: noise reduced, no gain boost, latency = FFT size; an order
+        chosen with setFftOrder() matches the constructor option
+
+    Test 11 (Low-Latency Mode / Reported Latency):
+      • Impulse over a low noise floor, standard and low-latency engines
+      • Verify: measured impulse delay = reported latency in both modes;
+        low-latency latency ≤ 512 samples and it still reduces noise
+
+    Test 12 (Double Precision):
+      • Sine + noise through processBlock (AudioBuffer<double>&), bypassed
+        and active
+      • Verify: bypass returns the input delayed by the latency bit for bit;
+        active output matches the float path within 1e-5
+
+    Test 13 (Display Snapshots):
+      • A reader thread polls a triple buffer while a writer publishes
+        frames; sine + noise through the processor, polled per block
+      • Verify: no torn frames; processor versions only move forward, at
+        about displayRefreshHz (published + dropped) with a subscriber and
+        not at all without one; the published spectrum shows the sine and
+        the worker's metrics are filled in; audio is unaffected
+
+    Test 14 (Bypass Fast Path):
+      • Sine + noise bypassed for ~2 s mid-stream, standard and low-latency
+        engines, with and without the bypassed noise tracker
+      • Verify: while bypassed the output is the input delayed by the
+        unchanged latency, bit for bit; on release the output level, per
+        256 samples against the dry signal, never dips by more than 1.5 dB
+        nor rises past the equal-power crossfade's +3 dB, and no sample step
+        exceeds the input's largest by more than that crossfade's √2
+
+    Test 15 (Silent Frames):
+      • Sine + noise with a 2 s gap of digital silence, of −125 dBFS noise
+        and of −85 dBFS noise
+      • Verify: inside a −125 dBFS gap no frame is processed (output exactly
+        0) and the music after it matches the digital-silence run; a
+        −85 dBFS gap is still processed
+
+    Test 16 (Unity-Gain Frames):
+      • Loud noise bursts alternating with a quiet hiss floor, mono and
+        stereo, with the unity-gain shortcut on and off
+      • Verify: some frames take the shortcut, the frame statistics report
+        them, and the output stays within −60 dB of the full path; a paired
+        frame is counted only when both channels take the shortcut
+
+    Test 17 (FFT Backends):
+      • Every backend at every FFT order against the double-precision
+        reference; sine + noise, mono and stereo, on each backend
+      • Verify: forward bins within 1e-5 of the peak; real and complex round
+        trips return the input at the declared gain; processor outputs
+        agree within 1e-5; automatic resolves to a measured backend and
+        matches that backend pinned explicitly
+
+    Test 18 (Callback Timing):
+      • Sine + noise, stereo; then a reset and a second run
+      • Verify: one histogram entry per callback; every stage measured and
+        the stages within the callbacks' wall time; a deadline fraction of
+        0 counts every callback as a miss and a huge one none; reset clears
+        the earlier run
+
+    Test 19 (Batch Rendering):
+      • Six WAV files of different lengths, mono and stereo, rendered one by
+        one with OfflineRenderer and as a batch on 1 and 3 threads
+      • Verify: every output has its input's length and all three renders
+        are bit-identical; results come back in job order; a bypassed
+        render reproduces the input exactly (latency fully trimmed); the
+        renderer defaults to the fixed juce FFT backend, and the simd
+        backend changes the output by less than 1e-5
+
+    Test 20 (Segmented Rendering):
+      • 9 s stereo file rendered serially and in 2 s segments on 2 and 3
+        threads, with 0 s and 4 s of pre-roll
+      • Verify: full length and the expected segment count; 2 and 3 threads
+        bit-identical; with pre-roll the difference from the serial render
+        is below −60 dB and smaller than without; bypassed segments stitch
+        back to the input within float rounding
+
+    Test 21 (Offline Three-Phase STFT):
+      • Stereo music with a silence gap (adaptive reset) and a bypass
+        toggle, in blocks that are not a whole number of hops: standard,
+        paired and unpaired, 16384-point and low-latency (mono)
+      • Verify: 1 and 3 offline threads reproduce the real-time path bit for
+        bit, with the same silent and unity-gain frame counts
   ==============================================================================
 */
 
 #include "PluginProcessor.h"
+#include "BatchRenderer.h"
 #include <cstdio>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
 #include <vector>
 
 //==============================================================================
-struct TestResult
+//  Shared runner for every helper below: prepares one processor, feeds the
+//  inputs through processBlock in host blocks and returns the output
+//  channels concatenated.  Helpers describe what differs through RunOptions.
+//==============================================================================
+template <typename SampleType>
+using Channels = std::vector<std::vector<SampleType>>;
+
+struct RunOptions
 {
-    double inRMS, outRMS, inPeak, outPeak, diffDB;
-    bool   pass;
+    int              fftOrder     = HisstoryAudioProcessor::defaultFftOrder;   // constructor argument
+    std::vector<int> blockSizes   { 512 };      // repeating pattern; the last block may be short
+    int              maxBlockSize = 512;        // passed to prepareToPlay
+
+    std::function<void (HisstoryAudioProcessor&)>      beforePrepare;
+    std::function<void (HisstoryAudioProcessor&)>      afterPrepare;
+    std::function<void (HisstoryAudioProcessor&, int)> beforeBlock;    // with the block's first sample
+    std::function<void (HisstoryAudioProcessor&)>      afterRun;       // before releaseResources
 };
 
-static TestResult runTest (const char* name, const std::vector<float>& testL,
-                           int totalSamples, int skipSamples)
+template <typename SampleType>
+static std::vector<SampleType> runProcessor (const Channels<SampleType>& inputs,
+                                             int totalSamples,
+                                             const RunOptions& options = {})
 {
-    HisstoryAudioProcessor proc;
+    HisstoryAudioProcessor proc (options.fftOrder);
     constexpr double sampleRate = 44100.0;
-    constexpr int    blockSize  = 512;
+    const int        numCh      = static_cast<int> (inputs.size());
+
+    if (options.beforePrepare)
+        options.beforePrepare (proc);
+
+    proc.setPlayConfigDetails (numCh, numCh, sampleRate, options.maxBlockSize);
+    proc.prepareToPlay (sampleRate, options.maxBlockSize);
 
-    proc.setPlayConfigDetails (1, 1, sampleRate, blockSize);
-    proc.prepareToPlay (sampleRate, blockSize);
+    if (options.afterPrepare)
+        options.afterPrepare (proc);
 
-    const int numBlocks = totalSamples / blockSize;
-    std::vector<float> outL (totalSamples, 0.0f);
+    std::vector<SampleType> output (static_cast<size_t> (totalSamples) * numCh, SampleType (0));
     juce::MidiBuffer midi;
 
-    for (int b = 0; b < numBlocks; ++b)
+    size_t k = 0;
+    for (int pos = 0; pos < totalSamples;)
     {
-        juce::AudioBuffer<float> buf (1, blockSize);
-        auto* L = buf.getWritePointer (0);
+        const int n = std::min (options.blockSizes[k++ % options.blockSizes.size()], totalSamples - pos);
 
-        for (int i = 0; i < blockSize; ++i)
-            L[i] = testL[b * blockSize + i];
+        if (options.beforeBlock)
+            options.beforeBlock (proc, pos);
+
+        juce::AudioBuffer<SampleType> buf (numCh, n);
+        for (int ch = 0; ch < numCh; ++ch)
+            std::copy (inputs[ch].begin() + pos, inputs[ch].begin() + pos + n, buf.getWritePointer (ch));
 
         proc.processBlock (buf, midi);
 
-        for (int i = 0; i < blockSize; ++i)
-            outL[b * blockSize + i] = L[i];
+        for (int ch = 0; ch < numCh; ++ch)
+            std::copy (buf.getReadPointer (ch), buf.getReadPointer (ch) + n,
+                       output.begin() + ch * totalSamples + pos);
+        pos += n;
     }
 
+    if (options.afterRun)
+        options.afterRun (proc);
+
+    proc.releaseResources();
+    return output;
+}
+
+/** Mono, or stereo with the right channel the input at −2 dB. */
+static Channels<float> withQuieterRight (const std::vector<float>& input, int numChannels)
+{
+    Channels<float> inputs (static_cast<size_t> (numChannels), input);
+
+    for (size_t ch = 1; ch < inputs.size(); ++ch)
+        for (auto& s : inputs[ch])
+            s *= 0.8f;
+
+    return inputs;
+}
+
+//==============================================================================
+//  Test 1–3 helper: mono run with level and peak checks
+//==============================================================================
+struct TestResult
+{
+    double inRMS, outRMS, inPeak, outPeak, diffDB;
+    bool   pass;
+};
+
+static TestResult runTest (const char* name, const std::vector<float>& testL,
+                           int totalSamples, int skipSamples)
+{
+    const auto outL = runProcessor<float> ({ testL }, totalSamples);
+
     // ── Analyse ──────────────────────────────────────────────────────────────
     double inRMS = 0.0, outRMS = 0.0;
     double inPeak = 0.0, outPeak = 0.0;
@@ -115,39 +289,285 @@ static TestResult runTest (const char* name, const std::vector<float>& testL,
 }
 
 //==============================================================================
-//  Test 4 helper: run processor and return output buffer
+//  Test 4 / 8 helper: run processor and return output buffer
 //==============================================================================
 static std::vector<float> processSignal (const std::vector<float>& input,
-                                          int totalSamples)
+                                          int totalSamples,
+                                          bool pairStereoFFT = true)
 {
-    HisstoryAudioProcessor proc;
-    constexpr double sampleRate = 44100.0;
-    constexpr int    blockSize  = 512;
+    RunOptions options;
+    options.beforePrepare = [pairStereoFFT] (auto& proc) { proc.setUsePairedStereoFFT (pairStereoFFT); };
 
-    proc.setPlayConfigDetails (1, 1, sampleRate, blockSize);
-    proc.prepareToPlay (sampleRate, blockSize);
+    return runProcessor<float> ({ input }, totalSamples, options);
+}
 
-    const int numBlocks = totalSamples / blockSize;
-    std::vector<float> output (totalSamples, 0.0f);
-    juce::MidiBuffer midi;
+//==============================================================================
+//  Test 5 helper: run processor with a repeating pattern of block sizes
+//==============================================================================
+static std::vector<float> processSignalWithBlockSizes (const std::vector<float>& input,
+                                                       int totalSamples,
+                                                       const std::vector<int>& blockSizes,
+                                                       int numChannels = 1)
+{
+    RunOptions options;
+    options.blockSizes   = blockSizes;
+    options.maxBlockSize = 8192;
 
-    for (int b = 0; b < numBlocks; ++b)
+    return runProcessor<float> (withQuieterRight (input, numChannels), totalSamples, options);
+}
+
+//==============================================================================
+//  Test 6 / 8 helper: stereo run with the selected kernel and FFT paths
+//==============================================================================
+static std::vector<float> processStereoWithKernels (const std::vector<float>& left,
+                                                    const std::vector<float>& right,
+                                                    int totalSamples,
+                                                    bool useReferenceKernels,
+                                                    bool pairStereoFFT = true,
+                                                    bool tiledFrameUpdate = false)
+{
+    RunOptions options;
+    options.beforePrepare = [=] (auto& proc)
     {
-        juce::AudioBuffer<float> buf (1, blockSize);
-        auto* L = buf.getWritePointer (0);
+        proc.setUseReferenceSpectrumKernels (useReferenceKernels);
+        proc.setUsePairedStereoFFT (pairStereoFFT);
+        proc.setUseTiledFrameUpdate (tiledFrameUpdate);
+    };
 
-        for (int i = 0; i < blockSize; ++i)
-            L[i] = input[b * blockSize + i];
+    return runProcessor<float> ({ left, right }, totalSamples, options);
+}
 
-        proc.processBlock (buf, midi);
+//==============================================================================
+//  Test 7 helper: apply threshold / band changes before or after prepareToPlay
+//==============================================================================
+static std::vector<float> processSignalWithThresholdChange (const std::vector<float>& input,
+                                                            int totalSamples,
+                                                            bool changeAfterPrepare)
+{
+    auto applyChanges = [] (HisstoryAudioProcessor& proc)
+    {
+        proc.apvts.getParameter ("threshold")->setValueNotifyingHost (0.8f);
+        proc.apvts.getParameter ("band4")->setValueNotifyingHost (0.9f);
+        proc.apvts.getParameter ("band5")->setValueNotifyingHost (0.1f);
+    };
 
-        for (int i = 0; i < blockSize; ++i)
-            output[b * blockSize + i] = L[i];
-    }
+    RunOptions options;
+    (changeAfterPrepare ? options.afterPrepare : options.beforePrepare) = applyChanges;
 
+    return runProcessor<float> ({ input }, totalSamples, options);
+}
+
+//==============================================================================
+//  Test 9 helper: N-channel run, optionally on the channel worker pool
+//==============================================================================
+static std::vector<float> processMultichannel (const std::vector<std::vector<float>>& inputs,
+                                               int totalSamples,
+                                               int workerThreads)
+{
+    RunOptions options;
+    options.beforePrepare = [workerThreads] (auto& proc) { proc.setChannelWorkerThreads (workerThreads); };
+
+    return runProcessor (inputs, totalSamples, options);
+}
+
+//==============================================================================
+//  Test 10 / 11 helper: mono run at a given FFT order, chosen either through
+//  the constructor or through setFftOrder() on a default-constructed processor
+//==============================================================================
+static std::vector<float> processWithFftOrder (const std::vector<float>& input,
+                                               int totalSamples,
+                                               int fftOrder,
+                                               bool useSetter,
+                                               int& latencySamples,
+                                               bool lowLatency = false)
+{
+    RunOptions options;
+    options.fftOrder = useSetter ? HisstoryAudioProcessor::defaultFftOrder : fftOrder;
+    options.beforePrepare = [=] (auto& proc)
+    {
+        if (useSetter)
+            proc.setFftOrder (fftOrder);
+
+        proc.setLowLatencyMode (lowLatency);
+    };
+    options.afterPrepare = [&latencySamples] (auto& proc) { latencySamples = proc.getLatencySamples(); };
+
+    return runProcessor<float> ({ input }, totalSamples, options);
+}
+
+//==============================================================================
+//  Test 12 helper: mono run through the 64-bit processBlock
+//==============================================================================
+static std::vector<double> processInDoublePrecision (const std::vector<double>& input,
+                                                     int totalSamples,
+                                                     bool bypassed,
+                                                     int& latencySamples)
+{
+    RunOptions options;
+    options.beforePrepare = [bypassed] (auto& proc)
+    {
+        if (bypassed)
+            proc.apvts.getParameter ("bypass")->setValueNotifyingHost (1.0f);
+
+        proc.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+    };
+    options.afterPrepare = [&latencySamples] (auto& proc) { latencySamples = proc.getLatencySamples(); };
+
+    return runProcessor<double> ({ input }, totalSamples, options);
+}
+
+//==============================================================================
+//  Test 14 helper: mono run with bypass engaged over [engageAt, releaseAt);
+//  latencySamples is -1 if the reported latency changed during the run
+//==============================================================================
+static std::vector<float> processWithBypassToggle (const std::vector<float>& input,
+                                                   int totalSamples,
+                                                   bool lowLatency,
+                                                   bool trackWhileBypassed,
+                                                   int engageAt,
+                                                   int releaseAt,
+                                                   int& latencySamples)
+{
+    RunOptions options;
+    options.beforePrepare = [=] (auto& proc)
+    {
+        proc.setLowLatencyMode (lowLatency);
+        proc.setTrackNoiseWhileBypassed (trackWhileBypassed);
+    };
+    options.afterPrepare = [&latencySamples] (auto& proc) { latencySamples = proc.getLatencySamples(); };
+    options.beforeBlock  = [=] (auto& proc, int pos)
+    {
+        proc.apvts.getParameter ("bypass")->setValueNotifyingHost (pos >= engageAt && pos < releaseAt ? 1.0f : 0.0f);
+    };
+    options.afterRun = [&latencySamples] (auto& proc)
+    {
+        if (proc.getLatencySamples() != latencySamples)
+            latencySamples = -1;
+    };
+
+    return runProcessor<float> ({ input }, totalSamples, options);
+}
+
+//==============================================================================
+//  Test 16 helper: mono or stereo run (the right channel is the input at
+//  −2 dB) with the unity-gain shortcut on or off; returns the left channel
+//==============================================================================
+static std::vector<float> processWithUnityGainSkip (const std::vector<float>& input,
+                                                    int totalSamples,
+                                                    int numChannels,
+                                                    bool skipUnityGain,
+                                                    HisstoryAudioProcessor::FrameStatistics& stats)
+{
+    RunOptions options;
+    options.beforePrepare = [skipUnityGain] (auto& proc) { proc.setSkipUnityGainFrames (skipUnityGain); };
+    options.afterRun      = [&stats] (auto& proc) { stats = proc.getFrameStatistics(); };
+
+    auto output = runProcessor (withQuieterRight (input, numChannels), totalSamples, options);
+    output.resize (static_cast<size_t> (totalSamples));
     return output;
 }
 
+//==============================================================================
+//  Test 17 helper: mono or stereo run (right channel at −2 dB) on a given FFT
+//  backend; returns the left channel and the backend the engine resolved
+//==============================================================================
+static std::vector<float> processWithFftBackend (const std::vector<float>& input,
+                                                 int totalSamples,
+                                                 int numChannels,
+                                                 FftBackend::Kind kind,
+                                                 FftBackend::Kind& activeKind)
+{
+    RunOptions options;
+    options.beforePrepare = [kind] (auto& proc) { proc.setFftBackend (kind); };
+    options.afterPrepare  = [&activeKind] (auto& proc) { activeKind = proc.getFftBackend(); };
+
+    auto output = runProcessor (withQuieterRight (input, numChannels), totalSamples, options);
+    output.resize (static_cast<size_t> (totalSamples));
+    return output;
+}
+
+//==============================================================================
+//  Test 19 helpers: 32-bit float WAV files
+//==============================================================================
+static bool writeFloatWav (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    file.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream (file.createOutputStream());
+    if (stream == nullptr) return false;
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer (
+        wav.createWriterFor (stream.get(), sampleRate, (unsigned int) buffer.getNumChannels(), 32, {}, 0));
+    if (writer == nullptr) return false;
+    stream.release();
+
+    return writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+}
+
+static juce::AudioBuffer<float> readWav (const juce::File& file)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    juce::AudioBuffer<float> buffer;
+    std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (file));
+
+    if (reader != nullptr)
+    {
+        buffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&buffer, 0, (int) reader->lengthInSamples, 0, true, true);
+    }
+
+    return buffer;
+}
+
+static bool buffersIdentical (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+{
+    if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+        return false;
+
+    for (int ch = 0; ch < a.getNumChannels(); ++ch)
+        if (! std::equal (a.getReadPointer (ch), a.getReadPointer (ch) + a.getNumSamples(), b.getReadPointer (ch)))
+            return false;
+
+    return true;
+}
+
+//==============================================================================
+//  Test 21 helper: multichannel run in large host blocks with the offline
+//  three-phase STFT on the given number of threads (0 = real-time path),
+//  bypassed over [bypassFrom, bypassTo); channels concatenated
+//==============================================================================
+static std::vector<float> processWithOfflineStft (const std::vector<std::vector<float>>& inputs,
+                                                  int totalSamples,
+                                                  int blockSize,
+                                                  int offlineThreads,
+                                                  int fftOrder,
+                                                  bool lowLatency,
+                                                  bool pairedStereo,
+                                                  int bypassFrom,
+                                                  int bypassTo,
+                                                  HisstoryAudioProcessor::FrameStatistics& stats)
+{
+    RunOptions options;
+    options.blockSizes    = { blockSize };
+    options.maxBlockSize  = blockSize;
+    options.beforePrepare = [=] (auto& proc)
+    {
+        proc.setFftOrder (fftOrder);
+        proc.setLowLatencyMode (lowLatency);
+        proc.setUsePairedStereoFFT (pairedStereo);
+        proc.setOfflineStftThreads (offlineThreads);
+    };
+    options.beforeBlock = [=] (auto& proc, int pos)
+    {
+        proc.apvts.getParameter ("bypass")->setValueNotifyingHost (pos >= bypassFrom && pos < bypassTo ? 1.0f : 0.0f);
+    };
+    options.afterRun = [&stats] (auto& proc) { stats = proc.getFrameStatistics(); };
+
+    return runProcessor (inputs, totalSamples, options);
+}
+
 //==============================================================================
 //  Measure RMS power of a specific frequency band via Goertzel
 //==============================================================================
@@ -302,6 +722,1021 @@ int main()
         r4pass = false;
     }
 
+    // ── Test 5: block-size independence ──────────────────────────────────────
+    //  The STFT FIFO is driven in hop-bounded spans, so any host block size
+    //  must give exactly the same output as fixed 512-sample blocks.  With
+    //  1-sample blocks every span is a single sample, which is how the FIFO
+    //  was driven before spans existed, so that run is the per-sample
+    //  reference.  Stereo covers the paired-FFT path as well.
+    std::printf ("\n=== Block-Size Independence ===\n");
+
+    bool r5pass = true;
+    for (int numCh : { 1, 2 })
+    {
+        const auto outFixed     = processSignalWithBlockSizes (sig1, totalSamples, { 512 }, numCh);
+        const auto outIrregular = processSignalWithBlockSizes (sig1, totalSamples,
+                                                               { 1, 7, 333, 1024, 1023, 2049, 5000, 64 }, numCh);
+        const auto outPerSample = processSignalWithBlockSizes (sig1, totalSamples, { 1 }, numCh);
+
+        const char* layout = numCh == 1 ? "mono  " : "stereo";
+        const auto check = [&] (const char* label, const std::vector<float>& out)
+        {
+            size_t i = 0;
+            while (i < outFixed.size() && outFixed[i] == out[i])
+                ++i;
+
+            if (i == outFixed.size())
+            {
+                std::printf ("  %s %-16s : identical across %zu samples\n", layout, label, outFixed.size());
+                return true;
+            }
+
+            std::printf ("FAIL: %s %s output diverges at channel %d sample %d\n",
+                         layout, label, static_cast<int> (i) / totalSamples, static_cast<int> (i) % totalSamples);
+            return false;
+        };
+
+        r5pass = check ("irregular blocks", outIrregular) && r5pass;
+        r5pass = check ("per-sample",       outPerSample) && r5pass;
+    }
+
+    // ── Test 6: vectorised kernels vs scalar reference ───────────────────────
+    std::printf ("\n=== Vectorised Kernels vs Reference ===\n");
+
+    const auto outSimd = processStereoWithKernels (sigMusic, sig1, totalSamples, false);
+    const auto outRef  = processStereoWithKernels (sigMusic, sig1, totalSamples, true);
+
+    double maxKernelDiff = 0.0;
+    for (size_t i = 0; i < outSimd.size(); ++i)
+        maxKernelDiff = std::max (maxKernelDiff, (double) std::abs (outSimd[i] - outRef[i]));
+
+    constexpr double kernelTolerance = 1e-5;
+    std::printf ("  Max abs difference: %.3g (tolerance %.0e)\n", maxKernelDiff, kernelTolerance);
+
+    // The tiled wavefront reorders work across bins, never within one.
+    const auto outTiled = processStereoWithKernels (sigMusic, sig1, totalSamples, false, true, true);
+    const bool tiledIdentical = (outTiled == outSimd);
+    std::printf ("  Tiled frame update identical to staged: %s\n", tiledIdentical ? "yes" : "NO");
+
+    const bool r6pass = (maxKernelDiff <= kernelTolerance) && tiledIdentical;
+
+    // ── Test 7: threshold table refresh ──────────────────────────────────────
+    //  The per-bin threshold table is only rebuilt when a parameter listener
+    //  bumps its version, so a change made after prepareToPlay must land.
+    std::printf ("\n=== Threshold Table Refresh ===\n");
+
+    const auto outChangedBefore = processSignalWithThresholdChange (sig1, totalSamples, false);
+    const auto outChangedAfter  = processSignalWithThresholdChange (sig1, totalSamples, true);
+    const auto outUnchanged     = processSignalWithBlockSizes (sig1, totalSamples, { 512 });
+
+    const bool tablesMatch   = std::equal (outChangedBefore.begin(), outChangedBefore.end(),
+                                           outChangedAfter.begin());
+    const bool changeAudible = ! std::equal (outChangedAfter.begin(), outChangedAfter.end(),
+                                             outUnchanged.begin());
+    const bool r7pass = tablesMatch && changeAudible;
+
+    std::printf ("  Changed before/after prepare identical: %s\n", tablesMatch ? "yes" : "no");
+    std::printf ("  Output differs from default settings:   %s\n", changeAudible ? "yes" : "no");
+
+    // ── Test 8: paired stereo FFT vs per-channel FFTs ────────────────────────
+    std::printf ("\n=== Paired Stereo FFT ===\n");
+
+    const auto outPaired  = processStereoWithKernels (sigMusic, sig1, totalSamples, false, true);
+    const auto outPerChan = processStereoWithKernels (sigMusic, sig1, totalSamples, false, false);
+
+    double maxPairDiff = 0.0;
+    for (size_t i = 0; i < outPaired.size(); ++i)
+        maxPairDiff = std::max (maxPairDiff, (double) std::abs (outPaired[i] - outPerChan[i]));
+
+    // Mono has nothing to pair, so the switch must not change anything.
+    const auto outMonoPaired  = processSignal (sig1, totalSamples, true);
+    const auto outMonoPerChan = processSignal (sig1, totalSamples, false);
+    const bool monoUnchanged  = std::equal (outMonoPaired.begin(), outMonoPaired.end(),
+                                            outMonoPerChan.begin());
+
+    constexpr double pairTolerance = 1e-5;
+    const bool r8pass = (maxPairDiff <= pairTolerance) && monoUnchanged;
+    std::printf ("  Max abs difference: %.3g (tolerance %.0e)\n", maxPairDiff, pairTolerance);
+    std::printf ("  Mono output unchanged: %s\n", monoUnchanged ? "yes" : "no");
+
+    // ── Test 9: multichannel, inline vs worker pool ──────────────────────────
+    std::printf ("\n=== Multichannel / Worker Pool ===\n");
+
+    bool layoutAccepted = false;
+    {
+        HisstoryAudioProcessor proc;
+        juce::AudioProcessor::BusesLayout surround;
+        surround.inputBuses.add  (juce::AudioChannelSet::create5point1());
+        surround.outputBuses.add (juce::AudioChannelSet::create5point1());
+        layoutAccepted = proc.isBusesLayoutSupported (surround);
+    }
+
+    bool poolIdentical = true;
+    for (int numCh : { 6, 5 })
+    {
+        std::vector<std::vector<float>> inputs;
+        for (int ch = 0; ch < numCh; ++ch)
+            inputs.push_back ((ch % 2 == 0) ? sigMusic : sig1);
+
+        const auto outInline = processMultichannel (inputs, totalSamples, 0);
+        const auto outPool   = processMultichannel (inputs, totalSamples, 3);
+        const bool same      = (outInline == outPool);
+        poolIdentical = poolIdentical && same;
+
+        std::printf ("  %d channels: inline vs pool %s\n", numCh, same ? "identical" : "DIFFER");
+    }
+
+    std::printf ("  5.1 layout accepted: %s\n", layoutAccepted ? "yes" : "no");
+    const bool r9pass = layoutAccepted && poolIdentical;
+
+    // ── Test 10: every FFT size ──────────────────────────────────────────────
+    std::printf ("\n=== FFT Sizes ===\n");
+
+    auto rmsDB = [&] (const std::vector<float>& x)
+    {
+        double sum = 0.0;
+        for (int i = skip; i < totalSamples; ++i)
+            sum += (double) x[i] * x[i];
+        return 10.0 * std::log10 (sum / (totalSamples - skip) + 1e-40);
+    };
+
+    auto peak = [&] (const std::vector<float>& x)
+    {
+        double p = 0.0;
+        for (int i = skip; i < totalSamples; ++i)
+            p = std::max (p, (double) std::abs (x[i]));
+        return p;
+    };
+
+    bool r10pass = true;
+    for (int order = HisstoryAudioProcessor::minFftOrder; order <= HisstoryAudioProcessor::maxFftOrder; ++order)
+    {
+        int latencyNoise = 0, latencySine = 0;
+        const auto outNoise = processWithFftOrder (sig2, totalSamples, order, false, latencyNoise);
+        const auto outSine  = processWithFftOrder (sig1, totalSamples, order, false, latencySine);
+
+        const double noiseChangeDB = rmsDB (outNoise) - rmsDB (sig2);
+        const double sineChangeDB  = rmsDB (outSine)  - rmsDB (sig1);
+        const bool   noBoost       = sineChangeDB <= 0.5 && peak (outSine) <= peak (sig1) * 1.05;
+        const bool   latencyOk     = latencyNoise == (1 << order) && latencySine == (1 << order);
+        const bool   ok            = noiseChangeDB < -1.0 && noBoost && latencyOk;
+        r10pass = r10pass && ok;
+
+        std::printf ("  %5d points: noise %+.1f dB, sine+noise %+.2f dB, latency %d  %s\n",
+                     1 << order, noiseChangeDB, sineChangeDB, latencyNoise, ok ? "ok" : "FAIL");
+    }
+
+    int latencySetter = 0, latencyCtor = 0;
+    const auto outSetter = processWithFftOrder (sig1, totalSamples, HisstoryAudioProcessor::minFftOrder,
+                                                true, latencySetter);
+    const auto outCtor   = processWithFftOrder (sig1, totalSamples, HisstoryAudioProcessor::minFftOrder,
+                                                false, latencyCtor);
+    const bool setterMatches = (outSetter == outCtor) && latencySetter == latencyCtor;
+    r10pass = r10pass && setterMatches;
+    std::printf ("  setFftOrder matches constructor option: %s\n", setterMatches ? "yes" : "no");
+
+    // ── Test 11: low-latency mode and reported latency ───────────────────────
+    //  An impulse over a −60 dBFS noise floor: the safety clamp limits any
+    //  wet output that is not aligned with the delayed dry signal, so the
+    //  impulse only survives at full level if the STFT path and the dry
+    //  delay line agree with the reported latency.
+    std::printf ("\n=== Low-Latency Mode / Reported Latency ===\n");
+
+    constexpr int impulsePos = 5000;
+    std::vector<float> sigImpulse (totalSamples);
+    std::srand (7);
+    for (int i = 0; i < totalSamples; ++i)
+        sigImpulse[i] = (static_cast<float> (std::rand()) / RAND_MAX * 2.0f - 1.0f) * 0.001f;
+    sigImpulse[impulsePos] += 0.5f;
+
+    bool r11pass = true;
+    int  lowLatencySamples = 0;
+    for (bool lowLatency : { false, true })
+    {
+        int reported = 0;
+        const auto out = processWithFftOrder (sigImpulse, totalSamples,
+                                              HisstoryAudioProcessor::defaultFftOrder,
+                                              false, reported, lowLatency);
+
+        const auto peakIt   = std::max_element (out.begin(), out.end(),
+                                                [] (float a, float b) { return std::abs (a) < std::abs (b); });
+        const int  measured = static_cast<int> (peakIt - out.begin()) - impulsePos;
+        const bool ok       = measured == reported && std::abs (*peakIt) > 0.25f;
+        r11pass = r11pass && ok;
+
+        if (lowLatency)
+            lowLatencySamples = reported;
+
+        std::printf ("  %-11s reported %5d, measured %5d, peak %.3f  %s\n",
+                     lowLatency ? "low latency" : "standard", reported, measured,
+                     std::abs (*peakIt), ok ? "ok" : "FAIL");
+    }
+
+    {
+        int latencyNoise = 0, latencySine = 0;
+        const auto outNoise = processWithFftOrder (sig2, totalSamples, HisstoryAudioProcessor::defaultFftOrder,
+                                                   false, latencyNoise, true);
+        const auto outSine  = processWithFftOrder (sig1, totalSamples, HisstoryAudioProcessor::defaultFftOrder,
+                                                   false, latencySine, true);
+
+        const double noiseChangeDB = rmsDB (outNoise) - rmsDB (sig2);
+        const double sineChangeDB  = rmsDB (outSine)  - rmsDB (sig1);
+        const bool   ok = lowLatencySamples <= 512 && noiseChangeDB < -1.0
+                       && sineChangeDB <= 0.5 && peak (outSine) <= peak (sig1) * 1.05;
+        r11pass = r11pass && ok;
+
+        std::printf ("  low latency: noise %+.1f dB, sine+noise %+.2f dB  %s\n",
+                     noiseChangeDB, sineChangeDB, ok ? "ok" : "FAIL");
+    }
+
+    // ── Test 12: double-precision processing ─────────────────────────────────
+    //  Bypassed, the 64-bit path must return the input delayed by the latency
+    //  without ever rounding through float.  Active, the STFT still runs in
+    //  float, so the output matches the float path to within its rounding.
+    std::printf ("\n=== Double Precision ===\n");
+
+    std::vector<double> sigDouble (totalSamples);
+    for (int i = 0; i < totalSamples; ++i)
+        sigDouble[i] = static_cast<double> (sig1[i]) + 1.0e-12 * std::sin (0.001 * i);
+
+    int latencyBypass = 0;
+    const auto outBypass = processInDoublePrecision (sigDouble, totalSamples, true, latencyBypass);
+
+    bool bypassExact = latencyBypass > 0;
+    for (int i = 0; i < totalSamples && bypassExact; ++i)
+        bypassExact = outBypass[i] == (i >= latencyBypass ? sigDouble[i - latencyBypass] : 0.0);
+
+    std::vector<double> sig1Double (sig1.begin(), sig1.end());
+    int latencyDouble = 0, latencyFloat = 0;
+    const auto outDouble = processInDoublePrecision (sig1Double, totalSamples, false, latencyDouble);
+    const auto outFloat  = processWithFftOrder (sig1, totalSamples, HisstoryAudioProcessor::defaultFftOrder,
+                                                false, latencyFloat);
+
+    constexpr double precisionTolerance = 1e-5;
+    double maxPrecisionDiff = 0.0;
+    for (int i = 0; i < totalSamples; ++i)
+        maxPrecisionDiff = std::max (maxPrecisionDiff, std::abs (outDouble[i] - (double) outFloat[i]));
+
+    const bool r12pass = bypassExact && latencyDouble == latencyFloat
+                      && maxPrecisionDiff < precisionTolerance;
+
+    std::printf ("  bypass bit-exact: %s, double vs float max diff %.3g\n",
+                 bypassExact ? "yes" : "no", maxPrecisionDiff);
+
+    // ── Test 13: display snapshots ───────────────────────────────────────────
+    //  Each published frame is filled with its own sequence number, so a
+    //  frame the reader sees half-written shows up as mixed values.
+    std::printf ("\n=== Display Snapshots ===\n");
+
+    struct TestFrame { uint64_t values[1024] {}; };
+    static TripleBuffer<TestFrame> frames;   // static: 24 KB
+
+    constexpr uint64_t numTestFrames = 200000;
+    std::atomic<bool> writerDone { false };
+    int  tornFrames = 0, framesSeen = 0;
+    bool framesInOrder = true;
+
+    std::thread writer ([&]
+    {
+        for (uint64_t n = 1; n <= numTestFrames; ++n)
+        {
+            auto& frame = frames.getWriteBuffer();
+            auto* half = std::begin (frame.values) + 512;
+            std::fill (std::begin (frame.values), half, n);
+
+            if (n % 64 == 0)
+                std::this_thread::yield();   // let the reader in mid-frame, even on one core
+
+            std::fill (half, std::end (frame.values), n);
+            frames.publish();
+        }
+        writerDone.store (true);
+    });
+
+    uint64_t lastSeen = 0;
+    for (bool done = false; ! done;)
+    {
+        done = writerDone.load();   // one more pass after the writer finishes
+
+        if (! frames.acquireLatest())
+            continue;
+
+        const auto& frame = frames.getReadBuffer();
+        const uint64_t n  = frame.values[0];
+        if (std::any_of (std::begin (frame.values), std::end (frame.values),
+                         [n] (uint64_t v) { return v != n; }))
+            ++tornFrames;
+
+        framesInOrder = framesInOrder && n > lastSeen;
+        lastSeen = n;
+        ++framesSeen;
+    }
+    writer.join();
+
+    const bool bufferOk = tornFrames == 0 && framesInOrder && lastSeen == numTestFrames;
+    std::printf ("  triple buffer: %d frames seen, %d torn, last %llu  %s\n",
+                 framesSeen, tornFrames, (unsigned long long) lastSeen, bufferOk ? "ok" : "FAIL");
+
+    //  The processor only publishes while a subscriber is registered, at
+    //  about displayRefreshHz; without one it publishes nothing after
+    //  prepareToPlay, and the audio is the same either way.
+    bool snapshotsOk = true;
+    std::vector<float> outWatched, outUnwatched;
+
+    for (bool watched : { true, false })
+    {
+        HisstoryAudioProcessor proc;
+        if (watched)
+            proc.addDisplaySubscriber();
+
+        proc.setPlayConfigDetails (1, 1, sampleRate, blockSize);
+        proc.prepareToPlay (sampleRate, blockSize);
+
+        // prepareToPlay publishes the default profile before any audio.
+        proc.waitForDisplayAnalysis();
+        uint64_t version = proc.getLatestDisplaySnapshot().version;
+        const uint64_t preparedVersion = version;
+        bool ok = preparedVersion > 0 && proc.getLatestDisplaySnapshot().noiseProfileReady;
+
+        auto& output = watched ? outWatched : outUnwatched;
+        output.assign (totalSamples, 0.0f);
+        juce::MidiBuffer midi;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            juce::AudioBuffer<float> buf (1, blockSize);
+            std::copy (sig1.begin() + b * blockSize, sig1.begin() + (b + 1) * blockSize,
+                       buf.getWritePointer (0));
+            proc.processBlock (buf, midi);
+            std::copy (buf.getReadPointer (0), buf.getReadPointer (0) + blockSize,
+                       output.begin() + b * blockSize);
+
+            const uint64_t v = proc.getLatestDisplaySnapshot().version;
+            ok = ok && v >= version;
+            version = v;
+        }
+
+        // Snapshots come from the analysis thread; let it catch up.  With no
+        // new frame after that, the reader keeps the snapshot it has.
+        ok = ok && proc.waitForDisplayAnalysis();
+        version = proc.getLatestDisplaySnapshot().version;
+        ok = ok && proc.getLatestDisplaySnapshot().version == version;
+
+        const auto& snapshot  = proc.getLatestDisplaySnapshot();
+        const int   hopsRun   = totalSamples / (HisstoryAudioProcessor::displayFftSize / 4);
+        const int   expected  = watched ? static_cast<int> (totalSamples * HisstoryAudioProcessor::displayRefreshHz
+                                                            / sampleRate)
+                                        : 0;
+        const int   published = static_cast<int> (version - preparedVersion);
+        const int   dropped   = static_cast<int> (snapshot.droppedFrames);
+
+        // Frames the worker could not keep up with are dropped, not lost
+        // track of: published + dropped accounts for every display frame.
+        ok = ok && std::abs (published + dropped - expected) <= 1;
+
+        if (watched)
+        {
+            const int   sineBin  = static_cast<int> (1000.0 / sampleRate * HisstoryAudioProcessor::displayFftSize + 0.5);
+            const float sineDB   = snapshot.inputSpectrumDB[sineBin];
+            const float nearbyDB = snapshot.inputSpectrumDB[sineBin + 40];
+            ok = ok && sineDB > nearbyDB + 20.0f;
+
+            std::printf ("  editor open:   %d snapshots + %d dropped for %d hops (expected ~%d), 1 kHz bin %+.1f dB vs %+.1f dB nearby  %s\n",
+                         published, dropped, hopsRun, expected, sineDB, nearbyDB, ok ? "ok" : "FAIL");
+            std::printf ("                 harmonic loss %.1f %%, %d tonal bins, band reduction %+.1f … %+.1f dB\n",
+                         snapshot.harmonicLossRatio * 100.0f, snapshot.tonalBinCount,
+                         snapshot.bandReductionDB[0], snapshot.bandReductionDB[HisstoryAudioProcessor::numBands - 1]);
+
+            ok = ok && snapshot.tonalBinCount > 0
+                    && snapshot.bandReductionDB[HisstoryAudioProcessor::numBands - 1] < -1.0f;
+        }
+        else
+        {
+            std::printf ("  editor closed: %d snapshots for %d hops  %s\n",
+                         published, hopsRun, ok ? "ok" : "FAIL");
+        }
+
+        snapshotsOk = snapshotsOk && ok;
+    }
+
+    const bool sameAudio = outWatched == outUnwatched;
+    snapshotsOk = snapshotsOk && sameAudio;
+    std::printf ("  audio identical with and without a subscriber: %s\n", sameAudio ? "yes" : "no");
+
+    const bool r13pass = bufferOk && snapshotsOk;
+
+    // ── Test 14: bypass fast path ────────────────────────────────────────────
+    //  Settled bypass runs only the delay line.  Releasing it must not expose
+    //  the frames skipped meanwhile: a partially rebuilt overlap-add would
+    //  show up as a level dip right after the crossfade.  The crossfade itself
+    //  may lift the level by up to 3 dB, as wet and dry are correlated.
+    std::printf ("\n=== Bypass Fast Path ===\n");
+
+    const int engageAt  = 200 * blockSize;     // ≈ 2.3 s
+    const int releaseAt = 400 * blockSize;     // ≈ 4.6 s
+
+    float maxInputStep = 0.0f;
+    for (int i = 1; i < totalSamples; ++i)
+        maxInputStep = std::max (maxInputStep, std::abs (sig1[i] - sig1[i - 1]));
+
+    bool r14pass = true;
+
+    const struct { const char* label; bool lowLatency; bool track; } bypassRuns[]
+    {
+        { "standard",            false, true  },
+        { "standard, no track",  false, false },
+        { "low latency",         true,  true  },
+    };
+
+    for (const auto& run : bypassRuns)
+    {
+        int latency = 0;
+        const auto out = processWithBypassToggle (sig1, totalSamples, run.lowLatency, run.track,
+                                                  engageAt, releaseAt, latency);
+
+        // Bypassed once the 10 ms crossfade has finished.
+        bool delayExact = latency > 0;
+        for (int i = engageAt + blockSize; i < releaseAt && delayExact; ++i)
+            delayExact = out[i] == sig1[i - latency];
+
+        // Release: level against the dry signal, and the largest sample step.
+        constexpr int window = 256;
+        double minLevelDB = 0.0, maxLevelDB = 0.0;
+        float  maxStep    = 0.0f;
+        const int checkEnd  = std::min (totalSamples, releaseAt + latency + 8192);
+
+        for (int w = releaseAt; w + window <= checkEnd; w += window)
+        {
+            double outSq = 0.0, drySq = 0.0;
+            for (int i = w; i < w + window; ++i)
+            {
+                outSq += (double) out[i] * out[i];
+                drySq += (double) sig1[i - latency] * sig1[i - latency];
+            }
+
+            const double levelDB = 10.0 * std::log10 ((outSq + 1e-20) / (drySq + 1e-20));
+            minLevelDB = std::min (minLevelDB, levelDB);
+            maxLevelDB = std::max (maxLevelDB, levelDB);
+        }
+
+        for (int i = releaseAt; i < checkEnd; ++i)
+            maxStep = std::max (maxStep, std::abs (out[i] - out[i - 1]));
+
+        const bool ok = delayExact && minLevelDB >= -1.5 && maxLevelDB <= 3.1
+                     && maxStep <= std::sqrt (2.0f) * maxInputStep;
+        r14pass = r14pass && ok;
+
+        std::printf ("  %-19s latency %4d, bypass %s, release level %+.2f / %+.2f dB, step %.3f (input %.3f)  %s\n",
+                     run.label, latency, delayExact ? "exact" : "NOT exact",
+                     minLevelDB, maxLevelDB, maxStep, maxInputStep, ok ? "ok" : "FAIL");
+    }
+
+    // ── Test 15: silent frames ───────────────────────────────────────────────
+    //  A frame below −100 dBFS is skipped, so nothing at all is overlap-added
+    //  once the last audible frame has passed; above that it is processed.
+    std::printf ("\n=== Silent Frames ===\n");
+
+    const int gapStart = 2 * static_cast<int> (sampleRate) / blockSize * blockSize;
+    const int gapEnd   = gapStart + 2 * static_cast<int> (sampleRate);
+
+    auto withGap = [&] (float gapAmplitude)
+    {
+        std::vector<float> sig (sig1);
+        std::srand (7);
+        for (int i = gapStart; i < gapEnd; ++i)
+            sig[i] = (static_cast<float> (std::rand()) / RAND_MAX * 2.0f - 1.0f) * gapAmplitude;
+        return sig;
+    };
+
+    int latencyZero = 0, latencyQuiet = 0, latencyAudible = 0;
+    const auto outZero    = processWithFftOrder (withGap (0.0f),    totalSamples, HisstoryAudioProcessor::defaultFftOrder,
+                                                 false, latencyZero);
+    const auto outQuiet   = processWithFftOrder (withGap (1.0e-6f), totalSamples, HisstoryAudioProcessor::defaultFftOrder,
+                                                 false, latencyQuiet);
+    const auto outAudible = processWithFftOrder (withGap (1.0e-4f), totalSamples, HisstoryAudioProcessor::defaultFftOrder,
+                                                 false, latencyAudible);
+
+    // Output samples whose every contributing frame lies inside the gap.
+    const int interiorStart = gapStart + 2 * HisstoryAudioProcessor::displayFftSize;
+
+    bool  quietSkipped = true;
+    float audiblePeak  = 0.0f;
+    for (int i = interiorStart; i < gapEnd; ++i)
+    {
+        quietSkipped = quietSkipped && outQuiet[i] == 0.0f;
+        audiblePeak  = std::max (audiblePeak, std::abs (outAudible[i]));
+    }
+
+    double maxAfterGapDiff = 0.0;
+    for (int i = gapEnd + latencyQuiet + HisstoryAudioProcessor::displayFftSize; i < totalSamples; ++i)
+        maxAfterGapDiff = std::max (maxAfterGapDiff, (double) std::abs (outQuiet[i] - outZero[i]));
+
+    constexpr double afterGapTolerance = 1e-4;
+    const bool r15pass = quietSkipped && audiblePeak > 0.0f && maxAfterGapDiff < afterGapTolerance;
+
+    std::printf ("  -125 dBFS gap skipped: %s, music after it vs silence gap: max diff %.3g\n",
+                 quietSkipped ? "yes" : "no", maxAfterGapDiff);
+    std::printf ("  -85 dBFS gap processed: %s (peak %.3g)\n",
+                 audiblePeak > 0.0f ? "yes" : "no", audiblePeak);
+
+    // ── Test 16: unity-gain frames ───────────────────────────────────────────
+    //  Loud broadband bursts over a quiet hiss floor leave every bin far above
+    //  the tracked noise, so their frames take the shortcut; the output must
+    //  stay within −60 dB of the full inverse-FFT path, measured per frame.
+    std::printf ("\n=== Unity-Gain Frames ===\n");
+
+    std::vector<float> sigLoud (totalSamples);
+    std::srand (31);
+    for (int i = 0; i < totalSamples; ++i)
+    {
+        const bool  burst = (i / static_cast<int> (sampleRate)) % 2 == 1;
+        const float level = burst ? 0.3f : 0.001f;
+        sigLoud[i] = (static_cast<float> (std::rand()) / RAND_MAX * 2.0f - 1.0f) * level;
+    }
+
+    bool r16pass = true;
+
+    for (const int numChannels : { 1, 2 })
+    {
+        HisstoryAudioProcessor::FrameStatistics statsSkip, statsFull;
+        const auto outSkip = processWithUnityGainSkip (sigLoud, totalSamples, numChannels, true,  statsSkip);
+        const auto outFull = processWithUnityGainSkip (sigLoud, totalSamples, numChannels, false, statsFull);
+
+        // Worst error per 4096-sample window, relative to that window's level.
+        constexpr int window = HisstoryAudioProcessor::displayFftSize;
+        double worstErrorDB = -200.0;
+
+        for (int w = 0; w + window <= totalSamples; w += window)
+        {
+            double errSq = 0.0, refSq = 0.0;
+            for (int i = w; i < w + window; ++i)
+            {
+                const double d = (double) outSkip[i] - outFull[i];
+                errSq += d * d;
+                refSq += (double) outFull[i] * outFull[i];
+            }
+
+            if (refSq > 0.0)
+                worstErrorDB = std::max (worstErrorDB, 10.0 * std::log10 (errSq / refSq + 1e-30));
+        }
+
+        const double unityRate = statsSkip.total > 0 ? (double) statsSkip.unityGain / (double) statsSkip.total : 0.0;
+        const bool ok = statsSkip.unityGain > 0 && statsFull.unityGain == 0
+                     && statsSkip.total == statsFull.total && worstErrorDB <= -60.0;
+        r16pass = r16pass && ok;
+
+        std::printf ("  %d ch: %llu frames, %llu unity gain (%.0f %%), worst error vs full path %.1f dB  %s\n",
+                     numChannels, (unsigned long long) statsSkip.total, (unsigned long long) statsSkip.unityGain,
+                     100.0 * unityRate, worstErrorDB, ok ? "ok" : "FAIL");
+    }
+
+    // A pair shares one inverse FFT, so it takes the shortcut for both
+    // channels or neither.  With a right channel of steady hiss, which
+    // qualifies far less often than the bursts, paired runs must count an
+    // even number of frames, and fewer than unpaired runs do.
+    {
+        std::vector<float> sigHiss (totalSamples);
+        std::srand (37);
+        for (auto& s : sigHiss)
+            s = (static_cast<float> (std::rand()) / RAND_MAX * 2.0f - 1.0f) * 0.001f;
+
+        HisstoryAudioProcessor::FrameStatistics statsPaired, statsUnpaired;
+
+        for (const bool paired : { true, false })
+        {
+            RunOptions options;
+            options.beforePrepare = [paired] (auto& proc)
+            {
+                proc.setSkipUnityGainFrames (true);
+                proc.setUsePairedStereoFFT (paired);
+            };
+            options.afterRun = [&] (auto& proc) { (paired ? statsPaired : statsUnpaired) = proc.getFrameStatistics(); };
+
+            runProcessor<float> ({ sigLoud, sigHiss }, totalSamples, options);
+        }
+
+        const bool ok = statsPaired.unityGain % 2 == 0 && statsPaired.unityGain < statsUnpaired.unityGain;
+        r16pass = r16pass && ok;
+
+        std::printf ("  loud + hiss: %llu unity-gain frames paired, %llu unpaired  %s\n",
+                     (unsigned long long) statsPaired.unityGain, (unsigned long long) statsUnpaired.unityGain,
+                     ok ? "ok" : "FAIL");
+    }
+
+    // ── Test 17: FFT backends ────────────────────────────────────────────────
+    //  Every backend against the double-precision reference at every order:
+    //  forward bins, and real and complex round trips against the gain the
+    //  backend declares (no probe).  Then the processor on each backend.
+    std::printf ("\n=== FFT Backends ===\n");
+
+    const FftBackend::Kind backendKinds[] { FftBackend::Kind::juce, FftBackend::Kind::simd, FftBackend::Kind::reference };
+    bool r17pass = true;
+
+    for (int order = HisstoryAudioProcessor::minFftOrder; order <= HisstoryAudioProcessor::maxFftOrder; ++order)
+    {
+        const int n = 1 << order;
+        auto reference = FftBackend::create (order, FftBackend::Kind::reference);
+
+        std::vector<float> signal (n);
+        std::srand (order);
+        for (auto& x : signal)
+            x = static_cast<float> (std::rand()) / RAND_MAX * 2.0f - 1.0f;
+
+        std::vector<float> expected (2 * n);
+        std::copy (signal.begin(), signal.end(), expected.begin());
+        reference->forwardReal (expected.data());
+
+        float peak = 0.0f;
+        for (int i = 0; i < n + 2; ++i)
+            peak = std::max (peak, std::abs (expected[i]));
+
+        std::printf ("  %5d:", n);
+
+        for (const auto kind : backendKinds)
+        {
+            auto fft = FftBackend::create (order, kind);
+            const float gain = fft->getRoundTripGain();
+
+            std::vector<float> data (2 * n);
+            std::copy (signal.begin(), signal.end(), data.begin());
+            fft->forwardReal (data.data());
+
+            float binError = 0.0f;
+            for (int i = 0; i < n + 2; ++i)
+                binError = std::max (binError, std::abs (data[i] - expected[i]));
+
+            fft->inverseReal (data.data());
+
+            float roundTripError = 0.0f;
+            for (int i = 0; i < n; ++i)
+                roundTripError = std::max (roundTripError, std::abs (data[i] / gain - signal[i]));
+
+            std::vector<std::complex<float>> packed (n), spectrum (n), unpacked (n);
+            for (int i = 0; i < n; ++i)
+                packed[i] = { signal[i], signal[n - 1 - i] };
+
+            fft->performComplex (packed.data(), spectrum.data(), false);
+            fft->performComplex (spectrum.data(), unpacked.data(), true);
+
+            for (int i = 0; i < n; ++i)
+                roundTripError = std::max (roundTripError, std::abs (unpacked[i] / gain - packed[i]));
+
+            const bool ok = fft->getKind() == kind && binError <= 1e-5f * peak && roundTripError <= 1e-5f;
+            r17pass = r17pass && ok;
+
+            std::printf ("  %s bins %.1e, round trip %.1e %s", FftBackend::getName (kind),
+                         binError / peak, roundTripError, ok ? "ok" : "FAIL");
+        }
+
+        std::printf ("\n");
+    }
+
+    for (const int numChannels : { 1, 2 })
+    {
+        FftBackend::Kind referenceKind, automaticKind;
+        const auto outReference = processWithFftBackend (sig1, totalSamples, numChannels,
+                                                         FftBackend::Kind::reference, referenceKind);
+        const auto outAutomatic = processWithFftBackend (sig1, totalSamples, numChannels,
+                                                         FftBackend::Kind::automatic, automaticKind);
+
+        double maxBackendDiff = 0.0;
+        for (const auto kind : backendKinds)
+        {
+            FftBackend::Kind activeKind;
+            const auto out = processWithFftBackend (sig1, totalSamples, numChannels, kind, activeKind);
+
+            for (int i = 0; i < totalSamples; ++i)
+                maxBackendDiff = std::max (maxBackendDiff, (double) std::abs (out[i] - outReference[i]));
+
+            r17pass = r17pass && activeKind == kind;
+        }
+
+        bool automaticMatches = true;
+        FftBackend::Kind pinnedKind;
+        const auto outPinned = processWithFftBackend (sig1, totalSamples, numChannels, automaticKind, pinnedKind);
+        for (int i = 0; i < totalSamples && automaticMatches; ++i)
+            automaticMatches = outAutomatic[i] == outPinned[i];
+
+        constexpr double backendTolerance = 1e-5;
+        const bool ok = referenceKind == FftBackend::Kind::reference
+                     && automaticKind != FftBackend::Kind::automatic && automaticKind != FftBackend::Kind::reference
+                     && automaticMatches && maxBackendDiff < backendTolerance;
+        r17pass = r17pass && ok;
+
+        std::printf ("  %d ch: automatic -> %s, max diff between backends %.3g  %s\n", numChannels,
+                     FftBackend::getName (automaticKind), maxBackendDiff, ok ? "ok" : "FAIL");
+    }
+
+    // ── Test 18: callback timing ─────────────────────────────────────────────
+    std::printf ("\n=== Callback Timing ===\n");
+
+    bool r18pass = true;
+
+    if constexpr (ProcessTiming::enabled)
+    {
+        HisstoryAudioProcessor proc;
+        proc.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+        proc.prepareToPlay (sampleRate, blockSize);
+
+        juce::MidiBuffer midi;
+        const auto runBlocks = [&] (int count)
+        {
+            for (int b = 0; b < count; ++b)
+            {
+                juce::AudioBuffer<float> buf (2, blockSize);
+                for (int ch = 0; ch < 2; ++ch)
+                    std::copy_n (sig1.begin() + b * blockSize, blockSize, buf.getWritePointer (ch));
+
+                proc.processBlock (buf, midi);
+            }
+        };
+
+        // Everything misses a zero deadline.
+        proc.setDeadlineFraction (0.0f);
+        runBlocks (numBlocks);
+        const auto first = proc.getTimingStatistics();
+
+        uint64_t histogramTotal = 0;
+        for (const auto count : first.histogram)
+            histogramTotal += count;
+
+        double stageTotal = 0.0;
+        bool   allStagesRan = true;
+        for (int i = 0; i < ProcessTiming::numStages; ++i)
+        {
+            stageTotal  += first.stageSeconds[(size_t) i];
+            allStagesRan = allStagesRan && first.stageSeconds[(size_t) i] > 0.0;
+            std::printf ("  %-16s %8.2f ms\n", ProcessTiming::getStageName (i), first.stageSeconds[(size_t) i] * 1.0e3);
+        }
+
+        std::printf ("  callbacks %llu, %.2f ms total, %.1f us max, %llu misses at fraction 0\n",
+                     (unsigned long long) first.callbacks, first.totalSeconds * 1.0e3,
+                     first.maxSeconds * 1.0e6, (unsigned long long) first.deadlineMisses);
+
+        r18pass = first.callbacks == (uint64_t) numBlocks
+               && first.samples == (uint64_t) totalSamples
+               && histogramTotal == first.callbacks
+               && first.deadlineMisses == first.callbacks
+               && allStagesRan
+               && stageTotal <= first.totalSeconds
+               && first.maxSeconds <= first.totalSeconds
+               && first.maxSeconds * (double) first.callbacks >= first.totalSeconds;
+
+        // Nothing misses a deadline a million blocks long; the reset drops
+        // the first run.
+        proc.resetTimingStatistics();
+        proc.setDeadlineFraction (1.0e6f);
+        runBlocks (numBlocks / 4);
+        const auto second = proc.getTimingStatistics();
+
+        std::printf ("  after reset: callbacks %llu, %llu misses at fraction 1e6\n",
+                     (unsigned long long) second.callbacks, (unsigned long long) second.deadlineMisses);
+
+        r18pass = r18pass
+               && second.callbacks == (uint64_t) (numBlocks / 4)
+               && second.deadlineMisses == 0
+               && second.totalSeconds < first.totalSeconds;
+    }
+    else
+    {
+        std::printf ("  timing compiled out (HISSTORY_ENABLE_TIMING=0)\n");
+    }
+
+    // ── Test 19: batch rendering ─────────────────────────────────────────────
+    std::printf ("\n=== Batch Rendering ===\n");
+
+    bool r19pass = true;
+    {
+        const auto dir = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                             .getChildFile ("hisstory-test-batch");
+        dir.deleteRecursively();
+        dir.createDirectory();
+
+        // Lengths deliberately not multiples of the render block.
+        std::vector<BatchRenderer::Job> jobs, jobs1, jobs3;
+        std::vector<juce::AudioBuffer<float>> inputs;
+
+        for (int f = 0; f < 6; ++f)
+        {
+            const int numChannels = 1 + f % 2;
+            const int length      = totalSamples / (f + 2) + 371 * f;
+
+            juce::AudioBuffer<float> buffer (numChannels, length);
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < length; ++i)
+                    buffer.setSample (ch, i, (ch == 0 ? sig1 : sig2)[(size_t) (i + 997 * f) % (size_t) totalSamples]);
+
+            const auto name  = "take" + juce::String (f);
+            const auto input = dir.getChildFile (name + ".wav");
+            r19pass = writeFloatWav (input, buffer, sampleRate) && r19pass;
+
+            jobs .push_back ({ input, dir.getChildFile (name + "_single.wav") });
+            jobs1.push_back ({ input, dir.getChildFile (name + "_batch1.wav") });
+            jobs3.push_back ({ input, dir.getChildFile (name + "_batch3.wav") });
+            inputs.push_back (std::move (buffer));
+        }
+
+        OfflineRenderer::Settings settings;
+        settings.blockSize     = 3000;
+        settings.bitsPerSample = 32;
+
+        const OfflineRenderer single (settings);
+        for (auto& job : jobs)
+        {
+            OfflineRenderer::Stats stats;
+            r19pass = single.render (job.input, job.output, stats).wasOk() && r19pass;
+        }
+
+        int progressCalls = 0;
+        const auto results1 = BatchRenderer (settings, 1).render (jobs1);
+        const auto results3 = BatchRenderer (settings, 3).render (jobs3, [&] (const BatchRenderer::JobResult&, int, int)
+                                                                          { ++progressCalls; });
+
+        for (size_t f = 0; f < jobs.size(); ++f)
+        {
+            const auto reference = readWav (jobs[f].output);
+            const bool ok = reference.getNumSamples() == inputs[f].getNumSamples()
+                         && results1[f].result.wasOk() && results3[f].result.wasOk()
+                         && results1[f].job.input == jobs[f].input && results3[f].job.input == jobs[f].input
+                         && buffersIdentical (reference, readWav (jobs1[f].output))
+                         && buffersIdentical (reference, readWav (jobs3[f].output));
+            r19pass = r19pass && ok;
+
+            std::printf ("  %s: %d ch, %d samples, batch worker %d  %s\n", jobs[f].input.getFileName().toRawUTF8(),
+                         inputs[f].getNumChannels(), inputs[f].getNumSamples(), results3[f].worker, ok ? "ok" : "FAIL");
+        }
+
+        // Bypassed, the render is the input delayed by the latency, which
+        // the renderer trims: the files must match exactly.
+        settings.parameters.set ("bypass", "on");
+        const OfflineRenderer bypassed (settings);
+        OfflineRenderer::Stats bypassStats;
+        const auto bypassFile = dir.getChildFile ("take1_bypass.wav");
+        const bool bypassOk = bypassed.render (jobs[1].input, bypassFile, bypassStats).wasOk()
+                           && bypassStats.latencySamples > 0
+                           && buffersIdentical (inputs[1], readWav (bypassFile));
+
+        std::printf ("  bypassed render matches the input (latency %d trimmed): %s\n",
+                     bypassStats.latencySamples, bypassOk ? "yes" : "NO");
+
+        // The renderer pins its FFT backend; another backend must take
+        // effect and agree to float rounding.
+        auto simdSettings = settings;
+        simdSettings.parameters.set ("bypass", "off");
+        simdSettings.fftBackend = FftBackend::Kind::simd;
+
+        OfflineRenderer::Stats simdStats;
+        OfflineRenderer::Difference backendDiff;
+        const auto simdFile = dir.getChildFile ("take1_simd.wav");
+        const bool backendOk = settings.fftBackend == FftBackend::Kind::juce
+                            && OfflineRenderer (simdSettings).render (jobs[1].input, simdFile, simdStats).wasOk()
+                            && OfflineRenderer::compare (simdFile, jobs[1].output, backendDiff).wasOk()
+                            && backendDiff.maxAbs > 0.0 && backendDiff.maxAbs < 1e-5;
+
+        std::printf ("  default backend %s; simd backend differs by %.3g: %s\n",
+                     FftBackend::getName (settings.fftBackend), backendDiff.maxAbs, backendOk ? "ok" : "FAIL");
+
+        r19pass = r19pass && bypassOk && backendOk && progressCalls == (int) jobs.size();
+        dir.deleteRecursively();
+    }
+
+    // ── Test 20: segmented rendering ─────────────────────────────────────────
+    std::printf ("\n=== Segmented Rendering ===\n");
+
+    bool r20pass = true;
+    {
+        const auto dir = juce::File::getSpecialLocation (juce::File::tempDirectory)
+                             .getChildFile ("hisstory-test-segments");
+        dir.deleteRecursively();
+        dir.createDirectory();
+
+        juce::AudioBuffer<float> buffer (2, totalSamples);
+        for (int i = 0; i < totalSamples; ++i)
+        {
+            buffer.setSample (0, i, sig1[(size_t) i]);
+            buffer.setSample (1, i, 0.5f * sig1[(size_t) i] + sig2[(size_t) i]);
+        }
+
+        const auto input  = dir.getChildFile ("input.wav");
+        const auto serial = dir.getChildFile ("serial.wav");
+        r20pass = writeFloatWav (input, buffer, sampleRate);
+
+        OfflineRenderer::Settings settings;
+        settings.bitsPerSample  = 32;
+        settings.segmentSeconds = 2.0;
+
+        OfflineRenderer::Stats serialStats;
+        r20pass = OfflineRenderer (settings).render (input, serial, serialStats).wasOk() && r20pass;
+
+        const auto renderSegmented = [&] (int threads, double preRoll, const char* name,
+                                          OfflineRenderer::Stats& stats)
+        {
+            settings.segmentThreads = threads;
+            settings.preRollSeconds = preRoll;
+            const auto file = dir.getChildFile (name);
+            r20pass = OfflineRenderer (settings).render (input, file, stats).wasOk() && r20pass;
+            return file;
+        };
+
+        OfflineRenderer::Stats stats2, stats3, statsCold;
+        const auto seg2 = renderSegmented (2, 4.0, "seg2.wav", stats2);
+        const auto seg3 = renderSegmented (3, 4.0, "seg3.wav", stats3);
+        const auto cold = renderSegmented (3, 0.0, "cold.wav", statsCold);
+
+        const int expectedSegments = (int) std::ceil (totalSamples / (settings.segmentSeconds * sampleRate));
+        const auto seg3Audio = readWav (seg3);
+
+        OfflineRenderer::Difference warmDiff, coldDiff;
+        r20pass = OfflineRenderer::compare (seg3, serial, warmDiff).wasOk()
+               && OfflineRenderer::compare (cold, serial, coldDiff).wasOk() && r20pass;
+
+        std::printf ("  %d segments, %d samples; 2 vs 3 threads identical: %s\n", stats3.numSegments,
+                     seg3Audio.getNumSamples(), buffersIdentical (readWav (seg2), seg3Audio) ? "yes" : "NO");
+        std::printf ("  vs serial, 4 s pre-roll: diff %.1f dBFS (max %.3g), signal/diff %.1f dB\n",
+                     warmDiff.rmsDb, warmDiff.maxAbs, warmDiff.signalToDifferenceDb);
+        std::printf ("  vs serial, no pre-roll:  diff %.1f dBFS (max %.3g), signal/diff %.1f dB\n",
+                     coldDiff.rmsDb, coldDiff.maxAbs, coldDiff.signalToDifferenceDb);
+
+        r20pass = r20pass
+               && stats3.numSegments == expectedSegments && stats2.numSegments == expectedSegments
+               && seg3Audio.getNumSamples() == totalSamples
+               && buffersIdentical (readWav (seg2), seg3Audio)
+               && warmDiff.rmsDb < -60.0
+               && warmDiff.rmsDb < coldDiff.rmsDb;
+
+        // Bypassed, every segment is the delayed input, so the crossfades
+        // blend identical samples.
+        settings.parameters.set ("bypass", "on");
+        OfflineRenderer::Stats bypassStats;
+        OfflineRenderer::Difference bypassDiff;
+        const auto bypassFile = renderSegmented (3, 4.0, "bypass.wav", bypassStats);
+        const bool bypassOk = OfflineRenderer::compare (bypassFile, input, bypassDiff).wasOk()
+                           && bypassDiff.maxAbs < 1.0e-6;
+
+        std::printf ("  bypassed segments vs input: max diff %.3g  %s\n", bypassDiff.maxAbs, bypassOk ? "ok" : "FAIL");
+
+        r20pass = r20pass && bypassOk;
+        dir.deleteRecursively();
+    }
+
+    // ── Test 21: offline three-phase STFT ────────────────────────────────────
+    //  The gap resets the adaptive profile (so unity-gain frames follow it);
+    //  the bypass toggle sends blocks through the real-time path mid-run.
+    std::printf ("\n=== Offline Three-Phase STFT ===\n");
+
+    bool r21pass = true;
+    {
+        const int gapFrom = static_cast<int> (sampleRate * 2.7);
+        const int gapTo   = gapFrom + static_cast<int> (sampleRate * 1.2);
+
+        std::vector<std::vector<float>> stereo (2, std::vector<float> (totalSamples));
+        for (int i = 0; i < totalSamples; ++i)
+        {
+            const bool inGap = i >= gapFrom && i < gapTo;
+            stereo[0][(size_t) i] = inGap ? 0.0f : sig1[(size_t) i];
+            stereo[1][(size_t) i] = inGap ? 0.0f : 0.5f * sig1[(size_t) i] + sig2[(size_t) i];
+        }
+
+        const std::vector<std::vector<float>> mono { stereo[0] };
+        const int bypassFrom = static_cast<int> (sampleRate * 6.0);
+        const int bypassTo   = static_cast<int> (sampleRate * 7.0);
+
+        struct Case { const char* name; const std::vector<std::vector<float>>* input; int fftOrder; bool lowLatency, paired; };
+        const Case cases[] = {
+            { "stereo, 4096, paired",     &stereo, HisstoryAudioProcessor::defaultFftOrder, false, true  },
+            { "stereo, 4096, unpaired",   &stereo, HisstoryAudioProcessor::defaultFftOrder, false, false },
+            { "stereo, 16384, paired",    &stereo, HisstoryAudioProcessor::maxFftOrder,     false, true  },
+            { "mono, 4096, low latency",  &mono,   HisstoryAudioProcessor::defaultFftOrder, true,  false },
+        };
+
+        constexpr int offlineBlock = 12000;
+
+        for (const auto& c : cases)
+        {
+            HisstoryAudioProcessor::FrameStatistics rtStats, stats1, stats3;
+            const auto realTime = processWithOfflineStft (*c.input, totalSamples, offlineBlock, 0, c.fftOrder,
+                                                          c.lowLatency, c.paired, bypassFrom, bypassTo, rtStats);
+            const auto lanes1   = processWithOfflineStft (*c.input, totalSamples, offlineBlock, 1, c.fftOrder,
+                                                          c.lowLatency, c.paired, bypassFrom, bypassTo, stats1);
+            const auto lanes3   = processWithOfflineStft (*c.input, totalSamples, offlineBlock, 3, c.fftOrder,
+                                                          c.lowLatency, c.paired, bypassFrom, bypassTo, stats3);
+
+            const auto sameStats = [&] (const HisstoryAudioProcessor::FrameStatistics& s)
+            {
+                return s.total == rtStats.total && s.silent == rtStats.silent && s.unityGain == rtStats.unityGain;
+            };
+
+            const bool ok = lanes1 == realTime && lanes3 == realTime && sameStats (stats1) && sameStats (stats3)
+                         && rtStats.silent > 0 && rtStats.unityGain > 0;
+            r21pass = r21pass && ok;
+
+            std::printf ("  %-24s frames %llu (%llu silent, %llu unity)  1 / 3 threads identical: %s / %s  %s\n",
+                         c.name, (unsigned long long) rtStats.total, (unsigned long long) rtStats.silent,
+                         (unsigned long long) rtStats.unityGain, lanes1 == realTime ? "yes" : "NO",
+                         lanes3 == realTime ? "yes" : "NO", ok ? "ok" : "FAIL");
+        }
+    }
+
     // ── Summary ──────────────────────────────────────────────────────────────
     std::printf ("\n================= SUMMARY =================\n");
 
@@ -332,6 +1767,97 @@ int main()
     { std::printf ("Test 4: FAIL  (music lost: %+.1f dB harmonic change)\n",
                    harmonicChangeDB); allPass = false; }
 
+    if (r5pass)
+        std::printf ("Test 5: PASS  (block-size independent)\n");
+    else
+    { std::printf ("Test 5: FAIL  (block-size dependent output)\n"); allPass = false; }
+
+    if (r6pass)
+        std::printf ("Test 6: PASS  (SIMD matches reference within %.0e; tiled = staged)\n", kernelTolerance);
+    else
+    { std::printf ("Test 6: FAIL  (SIMD differs from reference by %.3g%s)\n", maxKernelDiff,
+                   tiledIdentical ? "" : "; tiled differs from staged"); allPass = false; }
+
+    if (r7pass)
+        std::printf ("Test 7: PASS  (threshold changes refresh the per-bin table)\n");
+    else
+    { std::printf ("Test 7: FAIL  (stale per-bin threshold table)\n"); allPass = false; }
+
+    if (r8pass)
+        std::printf ("Test 8: PASS  (paired stereo FFT matches per-channel within %.0e)\n", pairTolerance);
+    else
+    { std::printf ("Test 8: FAIL  (paired stereo differs by %.3g, mono %s)\n",
+                   maxPairDiff, monoUnchanged ? "ok" : "changed"); allPass = false; }
+
+    if (r9pass)
+        std::printf ("Test 9: PASS  (multichannel worker pool matches inline processing)\n");
+    else
+    { std::printf ("Test 9: FAIL  (layout %s, pool output %s)\n",
+                   layoutAccepted ? "ok" : "rejected", poolIdentical ? "ok" : "differs"); allPass = false; }
+
+    if (r10pass)
+        std::printf ("Test 10: PASS  (all FFT sizes reduce noise without boost, latency = FFT size)\n");
+    else
+    { std::printf ("Test 10: FAIL  (see FFT Sizes above)\n"); allPass = false; }
+
+    if (r11pass)
+        std::printf ("Test 11: PASS  (impulse delay = reported latency; low-latency mode %d samples)\n",
+                     lowLatencySamples);
+    else
+    { std::printf ("Test 11: FAIL  (see Low-Latency Mode above)\n"); allPass = false; }
+
+    if (r12pass)
+        std::printf ("Test 12: PASS  (64-bit bypass bit-exact, matches float path within %.0e)\n",
+                     precisionTolerance);
+    else
+    { std::printf ("Test 12: FAIL  (bypass %s, double vs float diff %.3g)\n",
+                   bypassExact ? "exact" : "not exact", maxPrecisionDiff); allPass = false; }
+
+    if (r13pass)
+        std::printf ("Test 13: PASS  (whole-frame snapshots, only while subscribed, at the UI rate)\n");
+    else
+    { std::printf ("Test 13: FAIL  (see Display Snapshots above)\n"); allPass = false; }
+
+    if (r14pass)
+        std::printf ("Test 14: PASS  (bypass runs the delay line only; release is seamless)\n");
+    else
+    { std::printf ("Test 14: FAIL  (see Bypass Fast Path above)\n"); allPass = false; }
+
+    if (r15pass)
+        std::printf ("Test 15: PASS  (frames below -100 dBFS skipped; gap handling unchanged)\n");
+    else
+    { std::printf ("Test 15: FAIL  (see Silent Frames above)\n"); allPass = false; }
+
+    if (r16pass)
+        std::printf ("Test 16: PASS  (unity-gain frames skip the inverse FFT within -60 dB)\n");
+    else
+    { std::printf ("Test 16: FAIL  (see Unity-Gain Frames above)\n"); allPass = false; }
+
+    if (r17pass)
+        std::printf ("Test 17: PASS  (every FFT backend matches the reference at its declared scale)\n");
+    else
+    { std::printf ("Test 17: FAIL  (see FFT Backends above)\n"); allPass = false; }
+
+    if (r18pass)
+        std::printf ("Test 18: PASS  (callback and stage timing consistent, deadline and reset honoured)\n");
+    else
+    { std::printf ("Test 18: FAIL  (see Callback Timing above)\n"); allPass = false; }
+
+    if (r19pass)
+        std::printf ("Test 19: PASS  (batch renders identical on any thread count; output aligned and full length)\n");
+    else
+    { std::printf ("Test 19: FAIL  (see Batch Rendering above)\n"); allPass = false; }
+
+    if (r20pass)
+        std::printf ("Test 20: PASS  (segments stitch to full length, within -60 dB of a serial render)\n");
+    else
+    { std::printf ("Test 20: FAIL  (see Segmented Rendering above)\n"); allPass = false; }
+
+    if (r21pass)
+        std::printf ("Test 21: PASS  (offline three-phase STFT bit-identical to the real-time path)\n");
+    else
+    { std::printf ("Test 21: FAIL  (see Offline Three-Phase STFT above)\n"); allPass = false; }
+
     std::printf ("===========================================\n");
     std::printf ("Overall: %s\n", allPass ? "ALL PASS" : "SOME FAILED");
 
@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+    Hisstory – TripleBuffer.h
+
+    Lock-free single-writer / single-reader triple buffer, used to hand the
+    editor a consistent snapshot of the engine's display data.
+      • The writer fills its private back buffer and publishes it with one
+        atomic exchange; it never waits for the reader.
+      • The reader swaps in the latest published buffer only when there is
+        a new one, and may then read it for as long as it likes – the writer
+        can never touch a buffer the reader holds, so frames cannot tear.
+      • Intermediate frames are dropped if the writer outpaces the reader.
+  ==============================================================================
+*/
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+//==============================================================================
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    //── Writer side ───────────────────────────────────────────────────────────
+    /** The buffer being filled.  Its contents are whatever was published two
+        or more frames ago, so the writer must overwrite every field. */
+    T& getWriteBuffer() noexcept            { return buffers[static_cast<std::size_t> (writeIndex)]; }
+
+    /** Makes the write buffer the latest frame and takes the previous
+        middle buffer as the new write buffer. */
+    void publish() noexcept
+    {
+        const int previous = middle.exchange (writeIndex | freshFlag, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    //── Reader side ───────────────────────────────────────────────────────────
+    /** Swaps in the latest published frame if there is one since the last
+        call.  Returns true if the read buffer changed. */
+    bool acquireLatest() noexcept
+    {
+        if ((middle.load (std::memory_order_relaxed) & freshFlag) == 0)
+            return false;
+
+        const int previous = middle.exchange (readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    /** The frame acquired last; stable until the next acquireLatest(). */
+    const T& getReadBuffer() const noexcept { return buffers[static_cast<std::size_t> (readIndex)]; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int freshFlag = 4;
+
+    std::array<T, 3> buffers {};
+
+    // Writer, shared and reader state on separate cache lines.
+    alignas(64) int              writeIndex = 0;
+    alignas(64) std::atomic<int> middle     { 1 };
+    alignas(64) int              readIndex  = 2;
+
+    TripleBuffer (const TripleBuffer&) = delete;
+    TripleBuffer& operator= (const TripleBuffer&) = delete;
+};
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+    Hisstory – WorkerWakeup.cpp
+  ==============================================================================
+*/
+
+#include "WorkerWakeup.h"
+#include <chrono>
+#include <climits>
+#include <thread>
+
+#if defined (__linux__)
+ #include <linux/futex.h>
+ #include <sys/syscall.h>
+ #include <time.h>
+ #include <unistd.h>
+#elif defined (__APPLE__)
+ // The address-wait primitive libc++ builds std::atomic::wait on.
+ extern "C" int __ulock_wait (uint32_t operation, void* address, uint64_t value, uint32_t timeoutMicroseconds);
+ extern "C" int __ulock_wake (uint32_t operation, void* address, uint64_t wakeValue);
+#elif defined (_WIN32)
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+ #ifdef _MSC_VER
+  #pragma comment (lib, "Synchronization.lib")
+ #endif
+#endif
+
+//==============================================================================
+//  Platform address wait / wake
+//==============================================================================
+namespace
+{
+   #if defined (__APPLE__)
+    constexpr uint32_t ulockCompareAndWait = 1;
+    constexpr uint32_t ulockWakeAll        = 0x00000100;
+    constexpr uint32_t ulockNoErrno        = 0x01000000;
+   #endif
+
+    void waitOnAddress (std::atomic<uint32_t>& word, uint32_t expected, int timeoutMs) noexcept
+    {
+        auto* address = reinterpret_cast<uint32_t*> (&word);
+
+       #if defined (__linux__)
+        const timespec timeout { timeoutMs / 1000, (timeoutMs % 1000) * 1000000L };
+        syscall (SYS_futex, address, FUTEX_WAIT_PRIVATE, expected, &timeout, nullptr, 0);
+       #elif defined (__APPLE__)
+        __ulock_wait (ulockCompareAndWait | ulockNoErrno, address, expected,
+                      static_cast<uint32_t> (timeoutMs) * 1000u);
+       #elif defined (_WIN32)
+        WaitOnAddress (address, &expected, sizeof (expected), static_cast<DWORD> (timeoutMs));
+       #else
+        // No address wait: poll at 1 ms, which only slows the wake-up.
+        for (int ms = 0; ms < timeoutMs && word.load() == expected; ++ms)
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        (void) address;
+       #endif
+    }
+
+    void wakeAddress (std::atomic<uint32_t>& word) noexcept
+    {
+        auto* address = reinterpret_cast<uint32_t*> (&word);
+
+       #if defined (__linux__)
+        syscall (SYS_futex, address, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+       #elif defined (__APPLE__)
+        __ulock_wake (ulockCompareAndWait | ulockWakeAll | ulockNoErrno, address, 0);
+       #elif defined (_WIN32)
+        WakeByAddressAll (address);
+       #else
+        (void) address;
+       #endif
+    }
+}
+
+//==============================================================================
+//  The sequence bump and the parked flag are both sequentially consistent:
+//  either notify() sees the worker parked and wakes it, or the worker's
+//  kernel-side compare sees the new sequence number and does not sleep.
+//==============================================================================
+void WorkerWakeup::notify() noexcept
+{
+    sequence.fetch_add (1);
+
+    if (parked.load())
+        wakeAddress (sequence);
+}
+
+void WorkerWakeup::wait (uint32_t token, int timeoutMs) noexcept
+{
+    parked.store (true);
+
+    if (sequence.load() == token)
+        waitOnAddress (sequence, token, timeoutMs);
+
+    parked.store (false);
+}
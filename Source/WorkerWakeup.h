@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+    Hisstory – WorkerWakeup.h
+
+    Parks a worker thread until another thread – typically the audio thread –
+    wakes it, without the waking side ever taking a lock.
+      • notify() bumps an atomic sequence number and, only if the worker is
+        parked, asks the kernel to wake it: futex on Linux, __ulock on macOS,
+        WakeByAddress on Windows.  None of these takes a user-space mutex or
+        can block the caller, so there is no priority inversion with a
+        low-priority worker.  With the worker awake (spinning or busy),
+        notify() is two atomic operations and no system call.
+      • wait() parks until a notify() made after the matching prepareWait(),
+        or until the timeout.  One waiter per WorkerWakeup.
+    Usage on the worker side, so that a notify() racing with the check is
+    never lost:
+        const auto token = wakeup.prepareWait();
+        if (! workAvailable())
+            wakeup.wait (token, timeoutMs);
+  ==============================================================================
+*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+class WorkerWakeup
+{
+public:
+    /** Waker side: never blocks and never locks. */
+    void notify() noexcept;
+
+    /** Worker side: the token to pass to wait(), taken before checking for
+        work. */
+    uint32_t prepareWait() const noexcept   { return sequence.load(); }
+
+    /** Worker side: returns at once if notify() was called since
+        prepareWait() returned token, otherwise parks until it is or
+        timeoutMs elapses.  May also return spuriously. */
+    void wait (uint32_t token, int timeoutMs) noexcept;
+
+private:
+    std::atomic<uint32_t> sequence { 0 };
+    std::atomic<bool>     parked   { false };
+
+    static_assert (sizeof (std::atomic<uint32_t>) == sizeof (uint32_t)
+                    && std::atomic<uint32_t>::is_always_lock_free,
+                   "the kernel waits on the atomic's own storage");
+};